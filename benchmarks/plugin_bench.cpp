@@ -0,0 +1,748 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+/*
+ * A headless timing harness which drives the plugins through the same clap factory a
+ * host sees. Build it with -DSAPPHIRE_BUILD_BENCHMARKS=ON and run
+ *
+ *   sapphire-plugins-bench <mode> [args]
+ *
+ * with one of the modes listed in usage(). Numbers are wall clock, so run on a quiet
+ * machine and compare runs against each other rather than against absolutes.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <clap/clap.h>
+
+#include "clap/sapphire-clap-entry-impl.h"
+#include "shared/editor_queues.h"
+#include "shared/simd_dispatch.h"
+#include "elastika/lane_mesh.h"
+#include "elastika/mesh_tiers.h"
+#include "elastika/soa_mesh.h"
+#include "elastika/elastika.h"
+#include "tube_unit/tube_unit.h"
+#include "gravy/gravy.h"
+#include "galaxy/galaxy.h"
+
+namespace
+{
+using benchClock = std::chrono::steady_clock;
+
+double nsSince(benchClock::time_point start)
+{
+    return std::chrono::duration<double, std::nano>(benchClock::now() - start).count();
+}
+
+const char *allPluginIds[] = {sapphire_plugins::elastika::pluginId,
+                              sapphire_plugins::tube_unit::pluginId,
+                              sapphire_plugins::gravy::pluginId,
+                              sapphire_plugins::galaxy::pluginId};
+
+// A host which supports nothing, so the plugins fall back to their defaults
+struct BenchHost
+{
+    clap_host host{};
+
+    BenchHost()
+    {
+        host.clap_version = CLAP_VERSION;
+        host.host_data = this;
+        host.name = "sapphire-bench";
+        host.vendor = "Sapphire";
+        host.url = "";
+        host.version = "1";
+        host.get_extension = [](const clap_host *, const char *) -> const void *
+        { return nullptr; };
+        host.request_restart = [](const clap_host *) {};
+        host.request_process = [](const clap_host *) {};
+        host.request_callback = [](const clap_host *) {};
+    }
+};
+
+struct EventList
+{
+    std::vector<clap_event_param_value_t> events;
+    clap_input_events_t in{};
+    clap_output_events_t out{};
+
+    EventList()
+    {
+        in.ctx = this;
+        in.size = [](const clap_input_events *l) -> uint32_t
+        { return (uint32_t) static_cast<EventList *>(l->ctx)->events.size(); };
+        in.get = [](const clap_input_events *l, uint32_t i) -> const clap_event_header_t *
+        { return &static_cast<EventList *>(l->ctx)->events[i].header; };
+        out.ctx = this;
+        out.try_push = [](const clap_output_events *, const clap_event_header_t *) { return true; };
+    }
+
+    void addParam(uint32_t time, clap_id id, double value)
+    {
+        clap_event_param_value_t p{};
+        p.header.size = sizeof(p);
+        p.header.time = time;
+        p.header.space_id = CLAP_CORE_EVENT_SPACE_ID;
+        p.header.type = CLAP_EVENT_PARAM_VALUE;
+        p.param_id = id;
+        p.note_id = -1;
+        p.port_index = -1;
+        p.channel = -1;
+        p.key = -1;
+        p.value = value;
+        events.push_back(p);
+    }
+};
+
+const clap_plugin_factory *pluginFactory()
+{
+    static bool initialized = sapphire_plugins::clap_init("");
+    (void)initialized;
+    return static_cast<const clap_plugin_factory *>(
+        sapphire_plugins::get_factory(CLAP_PLUGIN_FACTORY_ID));
+}
+
+using makePlugin_t = std::function<const clap_plugin *(const clap_host *)>;
+
+makePlugin_t fromFactory(const char *id)
+{
+    return [id](const clap_host *h)
+    {
+        auto *f = pluginFactory();
+        return f->create_plugin(f, h, id);
+    };
+}
+
+/*
+ * One activated stereo instance with its own noise input, so the silence check never
+ * lets it sleep and every block runs the engine.
+ */
+struct Instance
+{
+    const clap_plugin *plugin{nullptr};
+    uint32_t blockSize;
+    std::vector<float> inData[2], outData[2];
+    float *inPtrs[2]{}, *outPtrs[2]{};
+    clap_audio_buffer_t inBuf{}, outBuf{};
+    EventList events;
+    int64_t steadyTime{0};
+
+    Instance(const BenchHost &h, const makePlugin_t &make, double sampleRate,
+             uint32_t blockSize)
+        : blockSize(blockSize)
+    {
+        plugin = make(&h.host);
+        if (!plugin || !plugin->init(plugin))
+        {
+            fprintf(stderr, "Unable to create a plugin\n");
+            std::exit(1);
+        }
+        plugin->activate(plugin, sampleRate, 1, blockSize);
+        plugin->start_processing(plugin);
+
+        std::minstd_rand gen(17);
+        std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+        for (int c = 0; c < 2; ++c)
+        {
+            inData[c].resize(blockSize);
+            outData[c].resize(blockSize);
+            for (auto &s : inData[c])
+                s = noise(gen);
+            inPtrs[c] = inData[c].data();
+            outPtrs[c] = outData[c].data();
+        }
+        inBuf.data32 = inPtrs;
+        inBuf.channel_count = 2;
+        outBuf.data32 = outPtrs;
+        outBuf.channel_count = 2;
+    }
+
+    ~Instance()
+    {
+        plugin->stop_processing(plugin);
+        plugin->deactivate(plugin);
+        plugin->destroy(plugin);
+    }
+
+    void process()
+    {
+        clap_process_t p{};
+        p.steady_time = steadyTime;
+        p.frames_count = blockSize;
+        p.audio_inputs = &inBuf;
+        p.audio_outputs = &outBuf;
+        p.audio_inputs_count = 1;
+        p.audio_outputs_count = 1;
+        p.in_events = &events.in;
+        p.out_events = &events.out;
+        plugin->process(plugin, &p);
+        steadyTime += blockSize;
+        events.events.clear();
+    }
+};
+
+/*
+ * The editor's side of the shim against its audio thread state, without the plugins. Each
+ * instance gets the shim's mailbox, its ui to audio ring and the per block fields the audio
+ * thread touches, once laid out as the shim has them now and once as they were before the
+ * audio state was regrouped, with the mailbox packed against the hot fields and an
+ * unpadded ring. Audio threads pop the ring, run a short one pole over a block and post
+ * to the mailbox, while an editor thread drains every mailbox and pushes a gesture into
+ * every ring as fast as it can, which is far harder than a 60Hz idle timer. If the layout
+ * shares lines between the two sides, the busy numbers go up.
+ */
+namespace stress
+{
+using sapphire_plugins::shared::cacheLineSize;
+using sapphire_plugins::shared::UIToAudioMsg;
+
+static constexpr size_t ringCapacity{64};
+static constexpr uint32_t postedParams{4};
+
+struct HotState
+{
+    double sampleRate{48000};
+    uint32_t smoothingBlock{8};
+    bool isEditorAttached{true};
+    uint32_t nextEventIndex{0};
+    uint32_t eventQSize{0};
+    size_t blockPos{0};
+    uint64_t quietOutputSamples{0};
+    float gesture{0.5f};
+    float state{0};
+};
+
+// The editor rings before SpscQueue, with both indices on one line and no cached copies
+template <typename T, size_t capacity> struct PackedRing
+{
+    T items[capacity]{};
+    std::atomic<size_t> readPos{0}, writePos{0};
+
+    bool push(const T &item)
+    {
+        auto w = writePos.load(std::memory_order_relaxed);
+        if (w - readPos.load(std::memory_order_acquire) == capacity)
+            return false;
+        items[w % capacity] = item;
+        writePos.store(w + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::optional<T> pop()
+    {
+        auto r = readPos.load(std::memory_order_relaxed);
+        if (r == writePos.load(std::memory_order_acquire))
+            return std::nullopt;
+        auto res = items[r % capacity];
+        readPos.store(r + 1, std::memory_order_release);
+        return res;
+    }
+};
+
+// The mailbox before its dirty mask got its own line
+struct PackedMailbox
+{
+    std::atomic<float> values[sapphire_plugins::shared::ParamMailbox::maxParams]{};
+    std::atomic<uint64_t> dirty{0};
+
+    void post(uint32_t index, float value)
+    {
+        values[index].store(value, std::memory_order_relaxed);
+        dirty.fetch_or((uint64_t)1 << index, std::memory_order_release);
+    }
+
+    template <typename F> void drain(F &&f)
+    {
+        auto d = dirty.exchange(0, std::memory_order_acquire);
+        while (d)
+        {
+            auto idx = sapphire_plugins::shared::lowestSetBit(d);
+            d &= d - 1;
+            f(idx, values[idx].load(std::memory_order_relaxed));
+        }
+    }
+};
+
+struct PackedLayout
+{
+    static constexpr const char *name{"packed (before)"};
+    PackedMailbox mailbox;
+    HotState hot;
+    PackedRing<UIToAudioMsg, ringCapacity> uiToAudio;
+};
+
+struct ShimLayout
+{
+    static constexpr const char *name{"shim (now)"};
+    sapphire_plugins::shared::ParamMailbox mailbox;
+    alignas(cacheLineSize) HotState hot;
+    sapphire_plugins::shared::SpscQueue<UIToAudioMsg, ringCapacity> uiToAudio;
+};
+
+template <typename Layout> void audioBlock(Layout &l, float *buf, uint32_t frames)
+{
+    auto &h = l.hot;
+    auto m = l.uiToAudio.pop();
+    while (m.has_value())
+    {
+        if (m->action == UIToAudioMsg::SET_PARAM)
+            h.gesture = m->value;
+        m = l.uiToAudio.pop();
+    }
+
+    h.eventQSize = 0;
+    h.nextEventIndex = 0;
+    auto st = h.state;
+    for (auto s = 0U; s < frames; ++s)
+    {
+        st = st * 0.99f + buf[s] * h.gesture;
+        buf[s] = st;
+    }
+    h.state = st;
+    h.blockPos = (h.blockPos + frames) & (h.smoothingBlock - 1);
+    h.quietOutputSamples += frames;
+
+    if (h.isEditorAttached)
+        for (auto p = 0U; p < postedParams; ++p)
+            l.mailbox.post(p, st + p);
+}
+
+template <typename Layout> void editorPass(Layout &l, float &sink, float gesture)
+{
+    l.mailbox.drain([&sink](uint32_t, float v) { sink += v; });
+    l.uiToAudio.push({UIToAudioMsg::SET_PARAM, 0, gesture});
+}
+
+// ns per instance block, with and without the editor thread running
+template <typename Layout> std::pair<double, double> run(int instances, int threads)
+{
+    static constexpr uint32_t blockSize{64};
+    static constexpr int blocks{20000};
+
+    // Separate allocations, as each real instance is
+    std::vector<std::unique_ptr<Layout>> insts;
+    std::vector<std::vector<float>> bufs;
+    for (auto i = 0; i < instances; ++i)
+    {
+        insts.push_back(std::make_unique<Layout>());
+        bufs.emplace_back(blockSize, 0.1f);
+    }
+
+    auto runAudio = [&](bool busy)
+    {
+        std::atomic<bool> done{false};
+        std::atomic<double> totalNs{0};
+        std::thread editor;
+        if (busy)
+        {
+            editor = std::thread(
+                [&]()
+                {
+                    float sink{0}, g{0};
+                    while (!done.load(std::memory_order_relaxed))
+                    {
+                        g = g > 1 ? 0 : g + 0.001f;
+                        for (auto &inst : insts)
+                            editorPass(*inst, sink, g);
+                    }
+                    if (sink == 1234.5f)
+                        printf(" ");
+                });
+        }
+
+        std::vector<std::thread> workers;
+        for (auto t = 0; t < threads; ++t)
+        {
+            workers.emplace_back(
+                [&, t]()
+                {
+                    auto start = benchClock::now();
+                    for (auto b = 0; b < blocks; ++b)
+                        for (auto i = t; i < instances; i += threads)
+                            audioBlock(*insts[i], bufs[i].data(), blockSize);
+                    auto ns = nsSince(start);
+                    auto cur = totalNs.load();
+                    while (!totalNs.compare_exchange_weak(cur, cur + ns))
+                        ;
+                });
+        }
+        for (auto &w : workers)
+            w.join();
+        done = true;
+        if (editor.joinable())
+            editor.join();
+
+        return totalNs.load() / ((double)blocks * instances);
+    };
+
+    runAudio(false); // warm up
+    auto quiet = runAudio(false);
+    auto busy = runAudio(true);
+    return {quiet, busy};
+}
+
+template <typename Layout> void report(int instances, int threads)
+{
+    auto [quiet, busy] = run<Layout>(instances, threads);
+    printf("  %-18s %12.1f %12.1f %8.1f%%\n", Layout::name, quiet, busy,
+           100.0 * (busy - quiet) / quiet);
+}
+} // namespace stress
+
+int runStress(int argc, char **argv)
+{
+    auto instances = argc > 0 ? std::atoi(argv[0]) : 64;
+    auto threads = argc > 1 ? std::atoi(argv[1]) : (int)std::thread::hardware_concurrency() - 1;
+    instances = std::max(instances, 1);
+    threads = std::max(threads, 1);
+
+    printf("stress: %d instances on %d audio threads against one editor thread\n", instances,
+           threads);
+    printf("  %-18s %12s %12s %9s\n", "layout", "quiet ns", "busy ns", "slowdown");
+    stress::report<stress::PackedLayout>(instances, threads);
+    stress::report<stress::ShimLayout>(instances, threads);
+    return 0;
+}
+
+/*
+ * What a host pays to scan and load a plugin: create_plugin plus init, then the first
+ * activate, which is where the engines get built, and the matching deactivate.
+ */
+int runStartup(int argc, char **argv)
+{
+    auto reps = argc > 0 ? std::atoi(argv[0]) : 200;
+    reps = std::max(reps, 1);
+    static constexpr uint32_t maxFrames{2048};
+
+    BenchHost host;
+    auto *f = pluginFactory();
+    printf("startup: mean of %d instances each\n", reps);
+    printf("  %-30s %12s %12s %12s\n", "plugin", "create us", "activate us", "deact us");
+
+    for (const auto *id : allPluginIds)
+    {
+        double createNs{0}, activateNs{0}, deactivateNs{0};
+        for (auto r = 0; r < reps; ++r)
+        {
+            auto start = benchClock::now();
+            auto *pl = f->create_plugin(f, &host.host, id);
+            if (!pl || !pl->init(pl))
+            {
+                fprintf(stderr, "Unable to create %s\n", id);
+                return 1;
+            }
+            createNs += nsSince(start);
+
+            start = benchClock::now();
+            pl->activate(pl, 48000, 1, maxFrames);
+            activateNs += nsSince(start);
+
+            start = benchClock::now();
+            pl->deactivate(pl);
+            deactivateNs += nsSince(start);
+
+            pl->destroy(pl);
+        }
+        printf("  %-30s %12.1f %12.1f %12.1f\n", id, createNs / reps / 1000,
+               activateNs / reps / 1000, deactivateNs / reps / 1000);
+    }
+    return 0;
+}
+
+/*
+ * The cost of automating a plugin's first param against leaving it alone. The sweep sends
+ * an event every 16 samples, so the smoothing never settles. Each plugin runs with the
+ * policy it ships with, which folds its own setter cost in, and Gravy also runs under
+ * stepped smoothing so the two policies compare on the same filter and param.
+ */
+int runSmoothing(int argc, char **argv)
+{
+    static constexpr uint32_t blockSize{256};
+    static constexpr uint32_t eventSpacing{16};
+    static constexpr int blocks{2000};
+    static constexpr clap_id sweptParam{100};
+
+    struct Variant
+    {
+        std::string name;
+        makePlugin_t make;
+    };
+    std::vector<Variant> variants;
+    for (const auto *id : allPluginIds)
+        variants.push_back({id, fromFactory(id)});
+    variants.push_back({std::string(sapphire_plugins::gravy::pluginId) + " (stepped)",
+                        sapphire_plugins::gravy::makeSteppedPluginForBench});
+
+    BenchHost host;
+    printf("smoothing: %u frame blocks, param %u moved every %u samples\n", blockSize,
+           sweptParam, eventSpacing);
+    printf("  %-36s %12s %12s %9s\n", "plugin", "static ns", "swept ns", "overhead");
+
+    for (const auto &v : variants)
+    {
+        if (argc > 0 && v.name.find(argv[0]) == std::string::npos)
+            continue;
+
+        auto timeRun = [&](bool sweep)
+        {
+            Instance inst(host, v.make, 48000, blockSize);
+            auto *pl = inst.plugin;
+            auto *params =
+                static_cast<const clap_plugin_params *>(pl->get_extension(pl, CLAP_EXT_PARAMS));
+            clap_param_info info;
+            params->get_info(pl, 0, &info);
+
+            uint64_t pos{0};
+            double ns{0};
+            for (auto b = 0; b < blocks; ++b)
+            {
+                if (sweep)
+                {
+                    for (auto t = 0U; t < blockSize; t += eventSpacing, pos += eventSpacing)
+                    {
+                        auto phase = (double)(pos % 48000) / 48000.0;
+                        auto tri = phase < 0.5 ? 2 * phase : 2 - 2 * phase;
+                        inst.events.addParam(
+                            t, info.id, info.min_value + tri * (info.max_value - info.min_value));
+                    }
+                }
+                auto start = benchClock::now();
+                inst.process();
+                ns += nsSince(start);
+            }
+            return ns / blocks;
+        };
+
+        timeRun(true); // warm up
+        auto still = timeRun(false);
+        auto swept = timeRun(true);
+        printf("  %-36s %12.1f %12.1f %8.1f%%\n", v.name.c_str(), still, swept,
+               100.0 * (swept - still) / still);
+    }
+    return 0;
+}
+
+namespace mesh
+{
+using sapphire_plugins::elastika::MeshBall;
+using sapphire_plugins::elastika::MeshSpring;
+
+// A square sheet with an anchored border and both diagonals braced, pulled in the middle
+void makeSheet(uint32_t side, std::vector<MeshBall> &balls, std::vector<MeshSpring> &springs)
+{
+    auto at = [side](uint32_t r, uint32_t c) { return r * side + c; };
+    for (auto r = 0U; r < side; ++r)
+        for (auto c = 0U; c < side; ++c)
+        {
+            bool edge = r == 0 || c == 0 || r == side - 1 || c == side - 1;
+            balls.push_back({(float)c, (float)r, 0.f, edge ? 0.f : 1.e-3f});
+        }
+    balls[at(side / 2, side / 2)].z = 0.3f;
+
+    const auto diag = 0.8f * std::sqrt(2.f);
+    for (auto r = 0U; r < side; ++r)
+        for (auto c = 0U; c < side; ++c)
+        {
+            if (c + 1 < side)
+                springs.push_back({at(r, c), at(r, c + 1), 0.8f});
+            if (r + 1 < side)
+                springs.push_back({at(r, c), at(r + 1, c), 0.8f});
+            if (r + 1 < side && c + 1 < side)
+            {
+                springs.push_back({at(r, c), at(r + 1, c + 1), diag});
+                springs.push_back({at(r, c + 1), at(r + 1, c), diag});
+            }
+        }
+}
+
+// The layout the SoA mesh replaces: a struct per ball, walked one spring at a time
+struct AosMesh
+{
+    struct Ball
+    {
+        float pos[3], vel[3], force[3], invMass;
+    };
+    std::vector<Ball> balls;
+    std::vector<MeshSpring> springs;
+
+    void update(float dt, float damp, float stiffness)
+    {
+        for (auto &b : balls)
+            b.force[0] = b.force[1] = b.force[2] = 0.f;
+        for (const auto &s : springs)
+        {
+            auto &a = balls[s.a], &b = balls[s.b];
+            float d[3];
+            for (int j = 0; j < 3; ++j)
+                d[j] = b.pos[j] - a.pos[j];
+            auto len = std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+            auto f = len > 0.f ? stiffness * (len - s.restLength) / len : 0.f;
+            for (int j = 0; j < 3; ++j)
+            {
+                a.force[j] += f * d[j];
+                b.force[j] -= f * d[j];
+            }
+        }
+        for (auto &b : balls)
+            for (int j = 0; j < 3; ++j)
+            {
+                b.vel[j] = damp * b.vel[j] + dt * b.invMass * b.force[j];
+                b.pos[j] += dt * b.vel[j];
+            }
+    }
+};
+
+static constexpr float dt{1.f / 48000}, halflife{0.05f}, stiffness{40.f};
+static constexpr int steps{48000};
+
+template <typename F> double nsPerStep(F &&step)
+{
+    for (int s = 0; s < steps / 10; ++s)
+        step();
+    auto start = benchClock::now();
+    for (int s = 0; s < steps; ++s)
+        step();
+    return nsSince(start) / steps;
+}
+} // namespace mesh
+
+/*
+ * One second of mesh steps at 48k, for the array of structs walk against the SoA mesh at
+ * each cpu level this machine can run.
+ */
+int runMesh(int argc, char **argv)
+{
+    auto side = argc > 0 ? (uint32_t)std::atoi(argv[0]) : 12U;
+    side = std::max(side, 3U);
+
+    std::vector<mesh::MeshBall> balls;
+    std::vector<mesh::MeshSpring> springs;
+    mesh::makeSheet(side, balls, springs);
+    printf("mesh: %zu balls, %zu springs, ns per step\n", balls.size(), springs.size());
+
+    mesh::AosMesh aos;
+    for (const auto &b : balls)
+        aos.balls.push_back({{b.x, b.y, b.z}, {}, {}, b.mass > 0.f ? 1.f / b.mass : 0.f});
+    aos.springs = springs;
+    const auto damp = std::pow(0.5f, mesh::dt / mesh::halflife);
+    auto aosNs = mesh::nsPerStep([&]() { aos.update(mesh::dt, damp, mesh::stiffness); });
+    printf("  %-18s %12.1f\n", "array of structs", aosNs);
+
+    namespace sps = sapphire_plugins::shared;
+    for (auto l = 0U; l <= (uint32_t)sps::SimdLevel::AVX512; ++l)
+    {
+        auto level = sps::simdLevelName((sps::SimdLevel)l);
+#if defined(_WIN32)
+        _putenv_s("SAPPHIRE_SIMD_LEVEL", level);
+#else
+        setenv("SAPPHIRE_SIMD_LEVEL", level, 1);
+#endif
+        sps::initSimdDispatch();
+        if (sps::activeSimdLevel() != (sps::SimdLevel)l)
+            continue;
+
+        sapphire_plugins::elastika::SoaMesh soa;
+        soa.build(balls, springs);
+        soa.setStiffness(mesh::stiffness);
+        auto ns = mesh::nsPerStep([&]() { soa.update(mesh::dt, mesh::halflife); });
+        printf("  soa %-14s %12.1f  (%u colours, %.2fx)\n", level, ns, soa.colourCount(),
+               aosNs / ns);
+    }
+
+    // The level of detail tiers, at whichever level the loop above left active
+    sapphire_plugins::elastika::MeshTiers tiers;
+    tiers.build(1.f, 1.f, 0.5f);
+    tiers.setStiffness(mesh::stiffness);
+    static constexpr const char *tierNames[]{"full", "medium", "light"};
+    for (auto t = 0U; t < sapphire_plugins::elastika::numMeshTiers; ++t)
+    {
+        tiers.select((sapphire_plugins::elastika::MeshTier)t);
+        const auto &m = tiers.active();
+        auto ns = mesh::nsPerStep([&]() { tiers.update(mesh::dt, mesh::halflife); });
+        printf("  hex %-14s %12.1f  (%u balls, %u springs)\n", tierNames[t], ns, m.ballCount(),
+               m.springCount());
+    }
+
+    // Four copies of the full tier, one at a time against one per lane
+    std::vector<mesh::MeshBall> hexBalls;
+    std::vector<mesh::MeshSpring> hexSprings;
+    sapphire_plugins::elastika::makeHexMesh(sapphire_plugins::elastika::MeshTiers::ringsFor[0],
+                                            1.f, 1.f, 0.5f, hexBalls, hexSprings);
+    static constexpr auto lanes = sapphire_plugins::elastika::LaneMesh::lanes;
+    sapphire_plugins::elastika::SoaMesh single[lanes];
+    sapphire_plugins::elastika::LaneMesh laned;
+    laned.build(hexBalls, hexSprings);
+    for (auto l = 0U; l < lanes; ++l)
+    {
+        single[l].build(hexBalls, hexSprings);
+        single[l].setStiffness(mesh::stiffness);
+        laned.setStiffness(l, mesh::stiffness);
+    }
+    auto singleNs = mesh::nsPerStep(
+        [&]()
+        {
+            for (auto &m : single)
+                m.update(mesh::dt, mesh::halflife);
+        });
+    auto lanedNs = mesh::nsPerStep([&]() { laned.update(mesh::dt, mesh::halflife); });
+    printf("  %-18s %12.1f\n", "hex full singly", singleNs);
+    printf("  %-18s %12.1f  (%.2fx)\n", "hex full lanes", lanedNs, singleNs / lanedNs);
+    return 0;
+}
+
+void usage()
+{
+    printf("usage: sapphire-plugins-bench <mode> [args]\n");
+    printf("  startup [repetitions]          create_plugin, init, activate and deactivate\n");
+    printf("  smoothing [plugin]             static against continuously automated params\n");
+    printf("  stress [instances] [threads]   audio thread state against a busy editor\n");
+    printf("  mesh [side]                    SoA against array of structs, LOD tiers, lanes\n");
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        usage();
+        return 1;
+    }
+
+    std::string mode = argv[1];
+    if (mode == "startup")
+        return runStartup(argc - 2, argv + 2);
+    if (mode == "smoothing")
+        return runSmoothing(argc - 2, argv + 2);
+    if (mode == "stress")
+        return runStress(argc - 2, argv + 2);
+    if (mode == "mesh")
+        return runMesh(argc - 2, argv + 2);
+
+    usage();
+    return 1;
+}
@@ -28,6 +28,7 @@
 #include "tube_unit/tube_unit.h"
 #include "gravy/gravy.h"
 #include "galaxy/galaxy.h"
+#include "shared/simd_dispatch.h"
 
 namespace sapphire_plugins
 {
@@ -159,6 +160,7 @@ bool clap_init(const char *p)
 {
     // sst::plugininfra::misc_platform::allocateConsole();
     SPLLOG("Initializing Sapphire");
+    shared::initSimdDispatch();
     return true;
 }
 void clap_deinit() {}
@@ -0,0 +1,58 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+/*
+ * Built once per cpu level like shared/simd_kernels.cpp. Above generic the build also
+ * defines Sapphire to a per level name, so this level's copy of the engine, and of the
+ * mesh sources built alongside it, can't collide with any other level's.
+ */
+
+#include "elastika/dispatched_engine.h"
+#include "elastika_engine.hpp"
+
+#ifndef SAPPHIRE_SIMD_NS
+#error "dispatched_engine.cpp needs SAPPHIRE_SIMD_NS from the build"
+#endif
+
+namespace sapphire_plugins::elastika::SAPPHIRE_SIMD_NS
+{
+namespace
+{
+struct Engine : DispatchedEngine
+{
+    Sapphire::ElastikaEngine eng;
+
+    void setFriction(float v) override { eng.setFriction(v); }
+    void setStiffness(float v) override { eng.setStiffness(v); }
+    void setSpan(float v) override { eng.setSpan(v); }
+    void setCurl(float v) override { eng.setCurl(v); }
+    void setMass(float v) override { eng.setMass(v); }
+    void setDrive(float v) override { eng.setDrive(v); }
+    void setGain(float v) override { eng.setGain(v); }
+    void setMix(float v) override { eng.setMix(v); }
+    void setInputTilt(float v) override { eng.setInputTilt(v); }
+    void setOutputTilt(float v) override { eng.setOutputTilt(v); }
+    void quiet() override { eng.quiet(); }
+
+    void process(double sampleRate, const float *inL, const float *inR, float *outL,
+                 float *outR, uint32_t frames) override
+    {
+        for (auto s = 0U; s < frames; ++s)
+            eng.process(sampleRate, inL[s], inR[s], outL[s], outR[s]);
+    }
+};
+} // namespace
+
+std::unique_ptr<DispatchedEngine> makeEngine() { return std::make_unique<Engine>(); }
+} // namespace sapphire_plugins::elastika::SAPPHIRE_SIMD_NS
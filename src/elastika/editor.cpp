@@ -22,30 +22,23 @@
 namespace sapphire_plugins::elastika
 {
 
-ElastikaEditor::ElastikaEditor(shared::audioToUIQueue_t &atou, shared::uiToAudioQueue_T &utoa,
+ElastikaEditor::ElastikaEditor(editorQueues_t &queues, shared::ParamMailbox &mailbox,
                                std::function<void()> flushOperator)
-    : audioToUI(atou), uiToAudio(utoa), flushOperator(flushOperator)
+    : editorQueues(queues), paramMailbox(mailbox), audioToUI(queues.audioToUI),
+      uiToAudio(queues.uiToAudio), flushOperator(flushOperator)
 {
     // Process any events we have
     idle();
 
-    auto knob_xml = juce::XmlDocument::parse(*shared::getSvgForPath("res/knob_graphics/knob.svg"));
-    auto marker_xml =
-        juce::XmlDocument::parse(*shared::getSvgForPath("res/knob_graphics/knob-marker.svg"));
-    lnf = std::make_unique<shared::LookAndFeel>(juce::Drawable::createFromSVG(*knob_xml),
-                                                juce::Drawable::createFromSVG(*marker_xml));
+    lnf = shared::getSharedLookAndFeel();
 
-    auto bg = shared::getSvgForPath("libs/sapphire/export/elastika.svg");
-    if (bg.has_value())
+    auto bg = shared::getSharedDrawable("libs/sapphire/export/elastika.svg");
+    if (bg)
     {
-        auto bgx = juce::XmlDocument::parse(*bg);
-        if (bgx)
-        {
-            background = juce::Drawable::createFromSVG(*bgx);
-            background->setInterceptsMouseClicks(false, true);
-
-            addAndMakeVisible(*background);
-        }
+        background = bg->createCopy();
+        background->setInterceptsMouseClicks(false, true);
+
+        addAndMakeVisible(*background);
     }
 
     const std::string modcode("elastika_export");
@@ -87,12 +80,12 @@ ElastikaEditor::ElastikaEditor(shared::audioToUIQueue_t &atou, shared::uiToAudio
     idleTimer = std::make_unique<shared::IdleTimer<ElastikaEditor>>(*this);
     idleTimer->startTimer(1000. / 60.);
 
-    uiToAudio.push({shared::UIToAudioMsg::EDITOR_ATTACH_DETATCH, true});
+    shared::attachEditor(*this);
 }
 
 ElastikaEditor::~ElastikaEditor()
 {
-    uiToAudio.push({shared::UIToAudioMsg::EDITOR_ATTACH_DETATCH, false});
+    shared::detachEditor(*this);
     idleTimer->stopTimer();
 }
 
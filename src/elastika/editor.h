@@ -29,7 +29,10 @@ struct ElastikaEditor : public juce::Component
 {
     Patch patchCopy;
 
-    ElastikaEditor(shared::audioToUIQueue_t &atou, shared::uiToAudioQueue_T &utoa,
+    // The audio thread only sends VU data down audioToUI, param values use the mailbox
+    using editorQueues_t = shared::EditorQueues<64, 1024>;
+
+    ElastikaEditor(editorQueues_t &queues, shared::ParamMailbox &mailbox,
                    std::function<void()> flushOperator);
     ~ElastikaEditor();
 
@@ -54,10 +57,12 @@ struct ElastikaEditor : public juce::Component
     std::unique_ptr<juce::Slider> span_slider;
     std::unique_ptr<juce::Slider> curl_slider;
 
-    std::unique_ptr<shared::LookAndFeel> lnf;
+    std::shared_ptr<shared::LookAndFeel> lnf;
 
-    shared::audioToUIQueue_t &audioToUI;
-    shared::uiToAudioQueue_T &uiToAudio;
+    editorQueues_t &editorQueues;
+    shared::ParamMailbox &paramMailbox;
+    editorQueues_t::audioToUI_t &audioToUI;
+    editorQueues_t::uiToAudio_t &uiToAudio;
     std::function<void()> flushOperator;
 
     std::unique_ptr<shared::Tooltip> tooltip;
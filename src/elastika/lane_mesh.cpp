@@ -0,0 +1,113 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#include "lane_mesh.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace sapphire_plugins::elastika
+{
+bool LaneMesh::build(const std::vector<MeshBall> &balls, const std::vector<MeshSpring> &springList)
+{
+    // The lanes have no conflicts to avoid, but taking the springs colour by colour, in
+    // the order SoaMesh does, gives every ball the same sum order as a single mesh
+    std::vector<uint32_t> colourOf;
+    uint32_t nColours{0};
+    if (!colourSprings((uint32_t)balls.size(), springList, colourOf, nColours))
+        return false;
+
+    const auto nb = (uint32_t)balls.size();
+    const auto ns = (uint32_t)springList.size();
+    const auto slots = nb * lanes;
+    using arena_t = shared::ScratchArena;
+    storage.unlock();
+    storage.reserve(13 * arena_t::bytesFor<float>(slots) + 2 * arena_t::bytesFor<uint32_t>(ns) +
+                    arena_t::bytesFor<float>(ns));
+
+    state = {};
+    state.balls = slots;
+    for (auto *arr : {&state.px, &state.py, &state.pz, &state.vx, &state.vy, &state.vz,
+                      &state.fx, &state.fy, &state.fz})
+        *arr = storage.allocate<float>(slots);
+    auto *invMass = storage.allocate<float>(slots);
+    auto *rx = storage.allocate<float>(slots);
+    auto *ry = storage.allocate<float>(slots);
+    auto *rz = storage.allocate<float>(slots);
+    for (auto i = 0U; i < nb; ++i)
+        for (auto l = 0U; l < lanes; ++l)
+        {
+            const auto at = slot(l, i);
+            rx[at] = balls[i].x;
+            ry[at] = balls[i].y;
+            rz[at] = balls[i].z;
+            invMass[at] = balls[i].mass > 0.f ? 1.f / balls[i].mass : 0.f;
+        }
+    state.invMass = invMass;
+    restX = rx;
+    restY = ry;
+    restZ = rz;
+
+    auto *a = storage.allocate<uint32_t>(ns);
+    auto *b = storage.allocate<uint32_t>(ns);
+    auto *rest = storage.allocate<float>(ns);
+    auto n = 0U;
+    for (auto c = 0U; c < nColours; ++c)
+        for (auto i = 0U; i < ns; ++i)
+        {
+            if (colourOf[i] != c)
+                continue;
+            a[n] = springList[i].a;
+            b[n] = springList[i].b;
+            rest[n] = springList[i].restLength;
+            ++n;
+        }
+    springs = {a, b, rest, ns};
+    storage.lock();
+    numBalls = nb;
+
+    quiet();
+    return true;
+}
+
+void LaneMesh::update(float dt, float halflife)
+{
+    if (dt != dampFor[0] || halflife != dampFor[1])
+    {
+        damp = std::pow(0.5f, dt / halflife);
+        dampFor[0] = dt;
+        dampFor[1] = halflife;
+    }
+
+    const auto &k = shared::simdKernels();
+    const auto bytes = state.balls * sizeof(float);
+    std::memset(state.fx, 0, bytes);
+    std::memset(state.fy, 0, bytes);
+    std::memset(state.fz, 0, bytes);
+    k.meshLaneSpringForces(springs, stiffness, state);
+    k.meshIntegrate(state, dt, damp);
+}
+
+void LaneMesh::quiet()
+{
+    if (state.balls == 0)
+        return;
+    const auto bytes = state.balls * sizeof(float);
+    std::memcpy(state.px, restX, bytes);
+    std::memcpy(state.py, restY, bytes);
+    std::memcpy(state.pz, restZ, bytes);
+    for (auto *arr : {state.vx, state.vy, state.vz, state.fx, state.fy, state.fz})
+        std::memset(arr, 0, bytes);
+}
+} // namespace sapphire_plugins::elastika
@@ -0,0 +1,76 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#ifndef SAPPHIRE_PLUGINS_ELASTIKA_LANE_MESH_H
+#define SAPPHIRE_PLUGINS_ELASTIKA_LANE_MESH_H
+
+#include <cstdint>
+#include <vector>
+
+#include "soa_mesh.h"
+
+namespace sapphire_plugins::elastika
+{
+/*
+ * Four independent copies of one mesh, stepped together with one copy in each SIMD lane.
+ * The copies share the balls, masses and springs, and each has its own stiffness and
+ * its own ball positions, so quad and surround channel pairs, or several instances with
+ * the same topology, can share one pass over the springs.
+ *
+ * Each lane does the same arithmetic in the same order as a SoaMesh built from the same
+ * balls and springs, so lane l matches that mesh given lane l's stiffness and moves to
+ * the bit. The storage is one ScratchArena block, as in SoaMesh.
+ */
+struct LaneMesh
+{
+    static constexpr uint32_t lanes{shared::meshLanes};
+
+    // Call off the audio thread. Fails if a ball has more springs than there are colours.
+    bool build(const std::vector<MeshBall> &balls, const std::vector<MeshSpring> &springs);
+
+    void update(float dt, float halflife);
+
+    // Every lane back to the positions the mesh was built with, at rest
+    void quiet();
+
+    void setStiffness(uint32_t lane, float k) { stiffness[lane] = k; }
+    void moveBall(uint32_t lane, uint32_t i, float x, float y, float z)
+    {
+        const auto at = slot(lane, i);
+        state.px[at] = x;
+        state.py[at] = y;
+        state.pz[at] = z;
+    }
+
+    uint32_t ballCount() const { return numBalls; }
+    uint32_t springCount() const { return springs.count; }
+
+    // Where lane's copy of ball i lives in the meshState() arrays
+    static uint32_t slot(uint32_t lane, uint32_t i) { return i * lanes + lane; }
+    const shared::MeshState &meshState() const { return state; }
+
+  private:
+    shared::ScratchArena storage;
+    shared::MeshState state{};
+    shared::MeshSpringBatch springs{};
+    const float *restX{nullptr}, *restY{nullptr}, *restZ{nullptr};
+    uint32_t numBalls{0};
+
+    float stiffness[lanes]{1.f, 1.f, 1.f, 1.f};
+    float dampFor[2]{-1.f, -1.f};
+    float damp{1.f};
+};
+} // namespace sapphire_plugins::elastika
+
+#endif // LANE_MESH_H
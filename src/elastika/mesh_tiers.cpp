@@ -0,0 +1,112 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#include "mesh_tiers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace sapphire_plugins::elastika
+{
+void makeHexMesh(uint32_t rings, float radius, float density, float restFraction,
+                 std::vector<MeshBall> &balls, std::vector<MeshSpring> &springs)
+{
+    // Axial coordinates (q, r); a ball's ring is its hex distance from the centre
+    const auto n = (int)rings;
+    const auto side = 2 * n + 1;
+    const auto h = radius / (float)rings;
+    const auto rowStep = std::sqrt(3.f) / 2.f;
+    const auto cellMass = density * rowStep * h * h;
+    auto ringOf = [](int q, int r)
+    { return std::max({std::abs(q), std::abs(r), std::abs(q + r)}); };
+
+    balls.clear();
+    springs.clear();
+    std::vector<uint32_t> index(side * side, 0);
+    for (auto q = -n; q <= n; ++q)
+        for (auto r = -n; r <= n; ++r)
+        {
+            auto ring = ringOf(q, r);
+            if (ring > n)
+                continue;
+            index[(q + n) * side + r + n] = (uint32_t)balls.size();
+            balls.push_back({h * (q + 0.5f * r), h * rowStep * r, 0.f, ring == n ? 0.f : cellMass});
+        }
+
+    static constexpr int dirs[3][2]{{1, 0}, {0, 1}, {-1, 1}};
+    for (auto q = -n; q <= n; ++q)
+        for (auto r = -n; r <= n; ++r)
+        {
+            if (ringOf(q, r) > n)
+                continue;
+            for (const auto &d : dirs)
+            {
+                auto q2 = q + d[0], r2 = r + d[1];
+                if (ringOf(q2, r2) > n || (ringOf(q, r) == n && ringOf(q2, r2) == n))
+                    continue;
+                springs.push_back({index[(q + n) * side + r + n], index[(q2 + n) * side + r2 + n],
+                                   restFraction * h});
+            }
+        }
+}
+
+bool MeshTiers::build(float radius, float density, float restFraction)
+{
+    std::vector<MeshSpring> springs;
+    for (auto t = 0U; t < numMeshTiers; ++t)
+    {
+        makeHexMesh(ringsFor[t], radius, density, restFraction, rest[t], springs);
+        if (!mesh[t].build(rest[t], springs))
+            return false;
+    }
+    quiet();
+    return true;
+}
+
+void MeshTiers::select(MeshTier t)
+{
+    if (t == tier)
+        return;
+    tier = t;
+    quiet();
+}
+
+void MeshTiers::quiet()
+{
+    mesh[(uint32_t)tier].quiet();
+    placeBalls(false);
+}
+
+void MeshTiers::setStiffness(float k)
+{
+    for (auto &m : mesh)
+        m.setStiffness(k);
+}
+
+void MeshTiers::setSpan(float s)
+{
+    span = s;
+    placeBalls(true);
+}
+
+void MeshTiers::placeBalls(bool anchorsOnly)
+{
+    auto &m = mesh[(uint32_t)tier];
+    const auto &balls = rest[(uint32_t)tier];
+    for (auto i = 0U; i < balls.size(); ++i)
+        if (!anchorsOnly || balls[i].mass == 0.f)
+            m.moveBall(i, span * balls[i].x, span * balls[i].y, balls[i].z);
+}
+} // namespace sapphire_plugins::elastika
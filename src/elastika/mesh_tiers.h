@@ -0,0 +1,83 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#ifndef SAPPHIRE_PLUGINS_ELASTIKA_MESH_TIERS_H
+#define SAPPHIRE_PLUGINS_ELASTIKA_MESH_TIERS_H
+
+#include <cstdint>
+#include <vector>
+
+#include "soa_mesh.h"
+
+namespace sapphire_plugins::elastika
+{
+/*
+ * A hexagon of balls on a triangular lattice, rings deep around a centre ball, with the
+ * outer ring anchored. Springs join lattice neighbours, apart from anchor to anchor ones,
+ * and their rest length is restFraction of the spacing, so the sheet starts in tension.
+ * Each inner ball carries the mass of its lattice cell at the given areal density.
+ */
+void makeHexMesh(uint32_t rings, float radius, float density, float restFraction,
+                 std::vector<MeshBall> &balls, std::vector<MeshSpring> &springs);
+
+enum struct MeshTier : uint32_t
+{
+    Full,
+    Medium,
+    Light
+};
+static constexpr uint32_t numMeshTiers{3};
+
+/*
+ * The same hex mesh at three levels of detail, all built up front so select() never
+ * allocates. The tiers share the radius, areal density, spring constant and the rest
+ * to spacing ratio. That keeps the tension per unit length and the mass per unit area
+ * the same, so the wave speed, and with it the pitch, stays put when the ball count
+ * drops. Stiffness goes to every tier and the span is kept here, so a switch keeps the
+ * response.
+ *
+ * A switch starts the new tier at rest, the same as quiet(), which puts every ball at
+ * its built position scaled by the span.
+ */
+struct MeshTiers
+{
+    static constexpr uint32_t ringsFor[numMeshTiers]{6, 4, 3};
+
+    // Call off the audio thread
+    bool build(float radius, float density, float restFraction);
+
+    void select(MeshTier t);
+    MeshTier selected() const { return tier; }
+
+    void setStiffness(float k);
+    // Scales the anchor ring about the centre; 1 is the built size
+    void setSpan(float s);
+
+    void update(float dt, float halflife) { mesh[(uint32_t)tier].update(dt, halflife); }
+    void quiet();
+
+    SoaMesh &active() { return mesh[(uint32_t)tier]; }
+    SoaMesh &meshFor(MeshTier t) { return mesh[(uint32_t)t]; }
+
+  private:
+    void placeBalls(bool anchorsOnly);
+
+    SoaMesh mesh[numMeshTiers];
+    std::vector<MeshBall> rest[numMeshTiers];
+    MeshTier tier{MeshTier::Full};
+    float span{1.f};
+};
+} // namespace sapphire_plugins::elastika
+
+#endif // MESH_TIERS_H
@@ -25,6 +25,7 @@
 #include "sst/cpputils/constructors.h"
 #include "sst/plugininfra/patch-support/patch_base.h"
 #include "shared/param_with_lag.h"
+#include "shared/param_table.h"
 
 namespace sapphire_plugins::elastika
 {
@@ -41,54 +42,42 @@ struct Patch : pats::PatchBase<Patch, Param>
     char name[256]{""};
 
     static constexpr uint32_t floatFlags{CLAP_PARAM_IS_AUTOMATABLE};
+    // Params which restart the plugin to take effect can't be automated
+    static constexpr uint32_t restartFlags{CLAP_PARAM_IS_STEPPED | CLAP_PARAM_REQUIRES_PROCESS};
 
-    static md_t floatMd() { return md_t().asFloat().withFlags(floatFlags); }
+    static constexpr shared::ParamTable<12> paramTable{{{
+        {100, "Friction", 0, 1, 0.5, floatFlags},
+        {120, "Stiffness", 0, 1, 0.5, floatFlags},
+        {110, "Span", 0, 1, 0.5, floatFlags},
+        {130, "Curl", -1, 1, 0, floatFlags},
+        {140, "Mass", -1, 1, 0, floatFlags},
+        {150, "Drive", 0, 2, 1, floatFlags},
+        {160, "Level", 0, 2, 1, floatFlags},
+        {170, "Mix", 0, 1, 1, floatFlags},
+        {180, "Input Tilt", 0, 1, 0.5, floatFlags},
+        {190, "Output Tilt", 0, 1, 0.5, floatFlags},
+        {200, "Oversampling", 0, 2, 0, restartFlags},
+        {210, "Physics Rate", 0, 1, 0, restartFlags},
+    }}};
+
+    template <clap_id id> static md_t md() { return shared::metaFor<paramTable, id>(); }
 
     Param friction, stiffness, span, curl, mass, drive, level, mix, inputTilt, outputTilt;
+    Param oversampling, physicsRate;
 
     Patch()
         : pats::PatchBase<Patch, Param>(),
-          friction(floatMd().withName("Friction").withID(100).asPercent().withDefault(0.5)),
-          span(floatMd().withName("Span").withID(110).asPercent().withDefault(0.5)),
-          stiffness(floatMd().withName("Stiffness").withID(120).asPercent().withDefault(0.5)),
-          curl(floatMd().withName("Curl").withID(130).asPercentBipolar().withDefault(0.f)),
-          mass(floatMd()
-                   .withName("Mass")
-                   .withID(140)
-                   .withRange(-1, 1)
-                   .withDefault(0.f)
-                   .withATwoToTheBFormatting(1.0, std::log2(10), "")),
-          drive(floatMd()
-                    .withName("Drive")
-                    .withID(150)
-                    .withRange(0., 2.)
-                    .withLogarithmicFormating("dB", 80, 10)
-                    .withDefault(1.f)),
-          level(floatMd()
-                    .withName("Level")
-                    .withID(160)
-                    .withRange(0., 2.)
-                    .withLogarithmicFormating("dB", 80, 10)
-                    .withDefault(1.f)),
-          mix(floatMd()
-                    .withName("Mix")
-                    .withID(170)
-                    .withRange(0., 1.)
-                    .withLinearScaleFormatting("")
-                    .withDefault(1.f)),
-          inputTilt(floatMd()
-                    .withName("Input Tilt")
-                    .withID(180)
-                    .withRange(0., 1.)
-                    .withDefault(0.5)
-                    .withLinearScaleFormatting(u8"\u00B0", 90)),
-          outputTilt(floatMd()
-                     .withName("Output Tilt")
-                     .withID(190)
-                     .withRange(0, 1)
-                     .withDefault(0.5)
-                     .withDecimalPlaces(3)
-                     .withLinearScaleFormatting(u8"\u00B0", 90))
+          friction(md<100>().asPercent()), span(md<110>().asPercent()),
+          stiffness(md<120>().asPercent()), curl(md<130>().asPercentBipolar()),
+          mass(md<140>().withATwoToTheBFormatting(1.0, std::log2(10), "")),
+          drive(md<150>().withLogarithmicFormating("dB", 80, 10)),
+          level(md<160>().withLogarithmicFormating("dB", 80, 10)),
+          mix(md<170>().withLinearScaleFormatting("")),
+          inputTilt(md<180>().withLinearScaleFormatting(u8"\u00B0", 90)),
+          outputTilt(md<190>().withDecimalPlaces(3).withLinearScaleFormatting(u8"\u00B0", 90)),
+          oversampling(
+              md<200>().withUnorderedMapFormatting({{0, "Off"}, {1, "2x"}, {2, "4x"}})),
+          physicsRate(md<210>().withUnorderedMapFormatting({{0, "Host"}, {1, "Fixed 48k"}}))
     {
         this->pushSingleParam(&friction);
         this->pushSingleParam(&stiffness);
@@ -100,6 +89,9 @@ struct Patch : pats::PatchBase<Patch, Param>
         this->pushSingleParam(&mix);
         this->pushSingleParam(&inputTilt);
         this->pushSingleParam(&outputTilt);
+        this->pushSingleParam(&oversampling);
+        this->pushSingleParam(&physicsRate);
+        assert(shared::paramsMatchTable(params, paramTable));
 
         onResetToInit = [](auto &patch)
         {
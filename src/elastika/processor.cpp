@@ -14,7 +14,7 @@
 
 #include "shared/processor_shim.h"
 
-#include "elastika_engine.hpp"
+#include "dispatched_engine.h"
 #include "elastika.h"
 #include "patch.h"
 #include "editor.h"
@@ -48,54 +48,59 @@ struct ElastikaClap : public shared::ProcessorShim<ElastikaClap>
     using param_t = Param;
     static constexpr bool hasStereoInput{true};
     static constexpr bool hasStereoOutput{true};
+    static constexpr bool supportsOversampling{true};
+    static constexpr bool supportsFixedEngineRate{true};
+    static constexpr double tailSeconds{4.0};
 
-    std::unique_ptr<Sapphire::ElastikaEngine> engine;
+    std::unique_ptr<DispatchedEngine> engine;
     Patch patch;
-    size_t blockPos{0};
 
     ElastikaClap(const clap_host *h) : shared::ProcessorShim<ElastikaClap>(getDescriptor(), h)
     {
-        engine = std::make_unique<Sapphire::ElastikaEngine>();
     }
 
-    clap_process_status process(const clap_process *process) noexcept override
+    void createEngine() { engine = makeDispatchedEngine(); }
+    void releaseEngine() { engine.reset(); }
+
+    void bindEngineSetters()
+    {
+        bindParamToEngine(patch.friction, [](auto &c, float v) { c.engine->setFriction(v); });
+        bindParamToEngine(patch.stiffness, [](auto &c, float v) { c.engine->setStiffness(v); });
+        bindParamToEngine(patch.span, [](auto &c, float v) { c.engine->setSpan(v); });
+        bindParamToEngine(patch.curl, [](auto &c, float v) { c.engine->setCurl(v); });
+        bindParamToEngine(patch.mass, [](auto &c, float v) { c.engine->setMass(v); });
+        bindParamToEngine(patch.drive, [](auto &c, float v) { c.engine->setDrive(v); });
+        bindParamToEngine(patch.level, [](auto &c, float v) { c.engine->setGain(v); });
+        bindParamToEngine(patch.mix, [](auto &c, float v) { c.engine->setMix(v); });
+        bindParamToEngine(patch.inputTilt, [](auto &c, float v) { c.engine->setInputTilt(v); });
+        bindParamToEngine(patch.outputTilt,
+                          [](auto &c, float v) { c.engine->setOutputTilt(v); });
+        bindParamToEngine(patch.oversampling, [](auto &c, float) { c.engineRateParamChanged(); });
+        bindParamToEngine(patch.physicsRate, [](auto &c, float) { c.engineRateParamChanged(); });
+    }
+
+    uint32_t requestedOversampling() const
+    {
+        return 1U << (uint32_t)std::round(patch.oversampling.value);
+    }
+
+    // The mesh sounds the same at 48k and above, so it can skip the extra host samples
+    bool requestedFixedEngineRate() const { return patch.physicsRate.value > 0.5f; }
+
+    void processEngineBlock(float **in, float **out, uint32_t offset, uint32_t frames,
+                            uint32_t)
+    {
+        engine->process(engineSampleRate, in[0] + offset, in[1] + offset, out[0] + offset,
+                        out[1] + offset, frames);
+    }
+
+    void reset() noexcept override
     {
-        auto ev = process->in_events;
-        auto outq = process->out_events;
-
-        float **in = process->audio_inputs[0].data32;
-        float **out = process->audio_outputs[0].data32;
-
-        shared::processUIQueueFromAudio(this, outq);
-
-        startProcessEventTraversal(ev);
-
-        for (auto s = 0U; s < process->frames_count; ++s)
-        {
-            if (blockPos == 0)
-            {
-                processEventsUpTo(s, ev);
-                for (auto &[i, p] : patch.paramMap)
-                    p->lag.process();
-                engine->setFriction(patch.friction.lag.v);
-                engine->setStiffness(patch.stiffness.lag.v);
-                engine->setSpan(patch.span.lag.v);
-                engine->setCurl(patch.curl.lag.v);
-                engine->setMass(patch.mass.lag.v);
-                engine->setDrive(patch.drive.lag.v);
-                engine->setGain(patch.level.lag.v);
-                engine->setMix(patch.mix.lag.v);
-                engine->setInputTilt(patch.inputTilt.lag.v);
-                engine->setOutputTilt(patch.outputTilt.lag.v);
-            }
-            engine->process(sampleRate, in[0][s], in[1][s], out[0][s], out[1][s]);
-            blockPos = (blockPos + 1) & (smoothingBlock - 1);
-        }
-
-        processEventsUpTo(process->frames_count, ev);
-        return CLAP_PROCESS_CONTINUE;
+        engine->quiet();
+        oversampler->reset();
+        smoothing.markAllChanged();
+        quietOutputSamples = 0;
     }
-    void reset() noexcept override { engine->quiet(); }
     bool handleNonParamEvent(const clap_event_header_t *nextEvent) { return false; }
 };
 
@@ -0,0 +1,146 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#include "soa_mesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace sapphire_plugins::elastika
+{
+bool colourSprings(uint32_t balls, const std::vector<MeshSpring> &springs,
+                   std::vector<uint32_t> &colourOf, uint32_t &colours)
+{
+    // Greedy edge colouring: each spring takes the lowest colour neither of its balls has
+    // used. That needs at most 2d - 1 colours for a ball degree of d.
+    std::vector<uint64_t> usedColours(balls, 0);
+    colourOf.resize(springs.size());
+    colours = 0;
+    for (auto i = 0U; i < springs.size(); ++i)
+    {
+        const auto &s = springs[i];
+        auto used = usedColours[s.a] | usedColours[s.b];
+        if (~used == 0)
+            return false;
+        auto c = 0U;
+        while (used & (1ULL << c))
+            ++c;
+        usedColours[s.a] |= 1ULL << c;
+        usedColours[s.b] |= 1ULL << c;
+        colourOf[i] = c;
+        colours = std::max(colours, c + 1);
+    }
+    return true;
+}
+
+bool SoaMesh::build(const std::vector<MeshBall> &balls, const std::vector<MeshSpring> &springs)
+{
+    std::vector<uint32_t> colourOf;
+    uint32_t nColours{0};
+    if (!colourSprings((uint32_t)balls.size(), springs, colourOf, nColours))
+        return false;
+    std::vector<uint32_t> perColour(nColours, 0);
+    for (auto c : colourOf)
+        ++perColour[c];
+
+    const auto nb = (uint32_t)balls.size();
+    const auto ns = (uint32_t)springs.size();
+    using arena_t = shared::ScratchArena;
+    auto bytes = 13 * arena_t::bytesFor<float>(nb);
+    for (auto c = 0U; c < nColours; ++c)
+        bytes += 2 * arena_t::bytesFor<uint32_t>(perColour[c]) +
+                 arena_t::bytesFor<float>(perColour[c]);
+    storage.unlock();
+    storage.reserve(bytes);
+
+    state = {};
+    state.balls = nb;
+    for (auto *arr : {&state.px, &state.py, &state.pz, &state.vx, &state.vy, &state.vz,
+                      &state.fx, &state.fy, &state.fz})
+        *arr = storage.allocate<float>(nb);
+    auto *invMass = storage.allocate<float>(nb);
+    auto *rx = storage.allocate<float>(nb);
+    auto *ry = storage.allocate<float>(nb);
+    auto *rz = storage.allocate<float>(nb);
+    for (auto i = 0U; i < nb; ++i)
+    {
+        rx[i] = balls[i].x;
+        ry[i] = balls[i].y;
+        rz[i] = balls[i].z;
+        invMass[i] = balls[i].mass > 0.f ? 1.f / balls[i].mass : 0.f;
+    }
+    state.invMass = invMass;
+    restX = rx;
+    restY = ry;
+    restZ = rz;
+
+    // Each colour gets its own aligned run of endpoints and rest lengths, in the order
+    // the springs were given
+    colours.assign(nColours, {});
+    for (auto c = 0U; c < nColours; ++c)
+    {
+        auto *a = storage.allocate<uint32_t>(perColour[c]);
+        auto *b = storage.allocate<uint32_t>(perColour[c]);
+        auto *rest = storage.allocate<float>(perColour[c]);
+        auto n = 0U;
+        for (auto i = 0U; i < ns; ++i)
+        {
+            if (colourOf[i] != c)
+                continue;
+            a[n] = springs[i].a;
+            b[n] = springs[i].b;
+            rest[n] = springs[i].restLength;
+            ++n;
+        }
+        colours[c] = {a, b, rest, n};
+    }
+    storage.lock();
+    numSprings = ns;
+
+    quiet();
+    return true;
+}
+
+void SoaMesh::update(float dt, float halflife)
+{
+    if (dt != dampFor[0] || halflife != dampFor[1])
+    {
+        damp = std::pow(0.5f, dt / halflife);
+        dampFor[0] = dt;
+        dampFor[1] = halflife;
+    }
+
+    const auto &k = shared::simdKernels();
+    const auto bytes = state.balls * sizeof(float);
+    std::memset(state.fx, 0, bytes);
+    std::memset(state.fy, 0, bytes);
+    std::memset(state.fz, 0, bytes);
+    for (const auto &c : colours)
+        k.meshSpringForces(c, stiffness, state);
+    k.meshIntegrate(state, dt, damp);
+}
+
+void SoaMesh::quiet()
+{
+    if (state.balls == 0)
+        return;
+    const auto bytes = state.balls * sizeof(float);
+    std::memcpy(state.px, restX, bytes);
+    std::memcpy(state.py, restY, bytes);
+    std::memcpy(state.pz, restZ, bytes);
+    for (auto *arr : {state.vx, state.vy, state.vz, state.fx, state.fy, state.fz})
+        std::memset(arr, 0, bytes);
+}
+} // namespace sapphire_plugins::elastika
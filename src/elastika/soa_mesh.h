@@ -0,0 +1,97 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#ifndef SAPPHIRE_PLUGINS_ELASTIKA_SOA_MESH_H
+#define SAPPHIRE_PLUGINS_ELASTIKA_SOA_MESH_H
+
+#include <cstdint>
+#include <vector>
+
+#include "shared/scratch_arena.h"
+#include "shared/simd_dispatch.h"
+
+namespace sapphire_plugins::elastika
+{
+// A ball with zero mass is an anchor, which only moves when moveBall puts it somewhere
+struct MeshBall
+{
+    float x, y, z;
+    float mass;
+};
+
+struct MeshSpring
+{
+    uint32_t a, b;
+    float restLength;
+};
+
+/*
+ * Gives each spring a colour so that no two springs of a colour share a ball, using at
+ * most SoaMesh::maxColours. Fails if a ball has too many springs for that.
+ */
+bool colourSprings(uint32_t balls, const std::vector<MeshSpring> &springs,
+                   std::vector<uint32_t> &colourOf, uint32_t &colours);
+
+/*
+ * A mass spring mesh stored as structure of arrays: positions, velocities, forces and
+ * inverse masses are separate x, y and z arrays, and springs are endpoint and rest
+ * length arrays. build() colours the springs so no two in a colour share a ball, which
+ * lets the force kernel run a whole colour in SIMD batches and scatter without
+ * conflicts. The kernels come from simd_dispatch.h, so they follow the cpu level.
+ *
+ * Each step is symplectic Euler with a velocity decay of 0.5 per halflife seconds. All
+ * the storage is one ScratchArena block, so build() allocates and update() never does.
+ */
+struct SoaMesh
+{
+    // Call off the audio thread. Fails if a ball has more springs than there are colours.
+    bool build(const std::vector<MeshBall> &balls, const std::vector<MeshSpring> &springs);
+
+    void update(float dt, float halflife);
+
+    // Back to the positions the mesh was built with, at rest
+    void quiet();
+
+    void setStiffness(float k) { stiffness = k; }
+    void moveBall(uint32_t i, float x, float y, float z)
+    {
+        state.px[i] = x;
+        state.py[i] = y;
+        state.pz[i] = z;
+    }
+
+    uint32_t ballCount() const { return state.balls; }
+    uint32_t springCount() const { return numSprings; }
+    uint32_t colourCount() const { return (uint32_t)colours.size(); }
+
+    // The springs in the order the kernels visit them, colour by colour
+    const std::vector<shared::MeshSpringBatch> &springBatches() const { return colours; }
+    const shared::MeshState &meshState() const { return state; }
+
+    static constexpr uint32_t maxColours{64};
+
+  private:
+    shared::ScratchArena storage;
+    shared::MeshState state{};
+    std::vector<shared::MeshSpringBatch> colours;
+    const float *restX{nullptr}, *restY{nullptr}, *restZ{nullptr};
+    uint32_t numSprings{0};
+
+    float stiffness{1.f};
+    float dampFor[2]{-1.f, -1.f};
+    float damp{1.f};
+};
+} // namespace sapphire_plugins::elastika
+
+#endif // SOA_MESH_H
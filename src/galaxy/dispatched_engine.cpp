@@ -0,0 +1,49 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+// Built once per cpu level; see elastika/dispatched_engine.cpp
+
+#include "galaxy/dispatched_engine.h"
+#include "galaxy_engine.hpp"
+
+#ifndef SAPPHIRE_SIMD_NS
+#error "dispatched_engine.cpp needs SAPPHIRE_SIMD_NS from the build"
+#endif
+
+namespace sapphire_plugins::galaxy::SAPPHIRE_SIMD_NS
+{
+namespace
+{
+struct Engine : DispatchedEngine
+{
+    Sapphire::Galaxy::Engine eng;
+
+    void setReplace(float v) override { eng.setReplace(v); }
+    void setBrightness(float v) override { eng.setBrightness(v); }
+    void setDetune(float v) override { eng.setDetune(v); }
+    void setBigness(float v) override { eng.setBigness(v); }
+    void setMix(float v) override { eng.setMix(v); }
+    void initialize() override { eng.initialize(); }
+
+    void process(double sampleRate, const float *inL, const float *inR, float *outL,
+                 float *outR, uint32_t frames) override
+    {
+        for (auto s = 0U; s < frames; ++s)
+            eng.process(sampleRate, inL[s], inR[s], outL[s], outR[s]);
+    }
+};
+} // namespace
+
+std::unique_ptr<DispatchedEngine> makeEngine() { return std::make_unique<Engine>(); }
+} // namespace sapphire_plugins::galaxy::SAPPHIRE_SIMD_NS
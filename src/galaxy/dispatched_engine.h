@@ -0,0 +1,65 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#ifndef SAPPHIRE_PLUGINS_GALAXY_DISPATCHED_ENGINE_H
+#define SAPPHIRE_PLUGINS_GALAXY_DISPATCHED_ENGINE_H
+
+#include <cstdint>
+#include <memory>
+
+#include "shared/simd_dispatch.h"
+
+namespace sapphire_plugins::galaxy
+{
+// The Galaxy delay network, built once per cpu level from dispatched_engine.cpp
+struct DispatchedEngine
+{
+    virtual ~DispatchedEngine() = default;
+
+    virtual void setReplace(float v) = 0;
+    virtual void setBrightness(float v) = 0;
+    virtual void setDetune(float v) = 0;
+    virtual void setBigness(float v) = 0;
+    virtual void setMix(float v) = 0;
+    virtual void initialize() = 0;
+
+    virtual void process(double sampleRate, const float *inL, const float *inR, float *outL,
+                         float *outR, uint32_t frames) = 0;
+};
+
+#define SAPPHIRE_DECLARE_GALAXY_ENGINE(ns)                                                         \
+    namespace ns                                                                                   \
+    {                                                                                              \
+    std::unique_ptr<DispatchedEngine> makeEngine();                                                \
+    }
+
+SAPPHIRE_DECLARE_GALAXY_ENGINE(simd_generic)
+#if SAPPHIRE_SIMD_X86
+SAPPHIRE_DECLARE_GALAXY_ENGINE(simd_avx2)
+SAPPHIRE_DECLARE_GALAXY_ENGINE(simd_avx512)
+#endif
+
+inline std::unique_ptr<DispatchedEngine> makeDispatchedEngine()
+{
+#if SAPPHIRE_SIMD_X86
+    static constexpr decltype(&simd_generic::makeEngine) byLevel[]{
+        simd_generic::makeEngine, simd_avx2::makeEngine, simd_avx512::makeEngine};
+#else
+    static constexpr decltype(&simd_generic::makeEngine) byLevel[]{simd_generic::makeEngine};
+#endif
+    return shared::forActiveLevel(byLevel)();
+}
+} // namespace sapphire_plugins::galaxy
+
+#endif // DISPATCHED_ENGINE_H
@@ -22,30 +22,23 @@
 namespace sapphire_plugins::galaxy
 {
 
-GalaxyEditor::GalaxyEditor(shared::audioToUIQueue_t &atou, shared::uiToAudioQueue_T &utoa,
+GalaxyEditor::GalaxyEditor(editorQueues_t &queues, shared::ParamMailbox &mailbox,
                            std::function<void()> flushOperator)
-    : audioToUI(atou), uiToAudio(utoa), flushOperator(flushOperator)
+    : editorQueues(queues), paramMailbox(mailbox), audioToUI(queues.audioToUI),
+      uiToAudio(queues.uiToAudio), flushOperator(flushOperator)
 {
     // Process any events we have
     idle();
 
-    auto knob_xml = juce::XmlDocument::parse(*shared::getSvgForPath("res/knob_graphics/knob.svg"));
-    auto marker_xml =
-        juce::XmlDocument::parse(*shared::getSvgForPath("res/knob_graphics/knob-marker.svg"));
-    lnf = std::make_unique<shared::LookAndFeel>(juce::Drawable::createFromSVG(*knob_xml),
-                                                juce::Drawable::createFromSVG(*marker_xml));
+    lnf = shared::getSharedLookAndFeel();
 
-    auto bg = shared::getSvgForPath("libs/sapphire/export/galaxy.svg");
-    if (bg.has_value())
+    auto bg = shared::getSharedDrawable("libs/sapphire/export/galaxy.svg");
+    if (bg)
     {
-        auto bgx = juce::XmlDocument::parse(*bg);
-        if (bgx)
-        {
-            background = juce::Drawable::createFromSVG(*bgx);
-            background->setInterceptsMouseClicks(false, true);
-
-            addAndMakeVisible(*background);
-        }
+        background = bg->createCopy();
+        background->setInterceptsMouseClicks(false, true);
+
+        addAndMakeVisible(*background);
     }
 
     const std::string modcode("galaxy_export");
@@ -72,12 +65,12 @@ GalaxyEditor::GalaxyEditor(shared::audioToUIQueue_t &atou, shared::uiToAudioQueu
     idleTimer = std::make_unique<shared::IdleTimer<GalaxyEditor>>(*this);
     idleTimer->startTimer(1000. / 60.);
 
-    uiToAudio.push({shared::UIToAudioMsg::EDITOR_ATTACH_DETATCH, true});
+    shared::attachEditor(*this);
 }
 
 GalaxyEditor::~GalaxyEditor()
 {
-    uiToAudio.push({shared::UIToAudioMsg::EDITOR_ATTACH_DETATCH, false});
+    shared::detachEditor(*this);
     idleTimer->stopTimer();
 }
 
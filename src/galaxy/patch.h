@@ -24,6 +24,7 @@
 #include "galaxy.h"
 #include "sst/plugininfra/patch-support/patch_base.h"
 #include "shared/param_with_lag.h"
+#include "shared/param_table.h"
 
 namespace sapphire_plugins::galaxy
 {
@@ -41,23 +42,29 @@ struct Patch : pats::PatchBase<Patch, Param>
 
     static constexpr uint32_t floatFlags{CLAP_PARAM_IS_AUTOMATABLE};
 
-    static md_t floatMd() { return md_t().asFloat().withFlags(floatFlags); }
+    static constexpr shared::ParamTable<5> paramTable{{{
+        {100, "Replace", 0, 1, 0.5, floatFlags},
+        {110, "Brightness", 0, 1, 0.5, floatFlags},
+        {120, "Detune", 0, 1, 0.5, floatFlags},
+        {130, "Bigness", 0, 1, 0.5, floatFlags},
+        {140, "Mix", 0, 1, 0.5, floatFlags},
+    }}};
+
+    template <clap_id id> static md_t md() { return shared::metaFor<paramTable, id>(); }
 
     Param replace, brightness, detune, bigness, mix;
 
     Patch()
         : pats::PatchBase<Patch, Param>(),
-          replace(floatMd().withName("Replace").withID(100).asPercent().withDefault(0.5)),
-          brightness(floatMd().withName("Brightness").withID(110).asPercent().withDefault(0.5)),
-          detune(floatMd().withName("Detune").withID(120).asPercent().withDefault(0.5)),
-          bigness(floatMd().withName("Bigness").withID(130).asPercent().withDefault(0.5)),
-          mix(floatMd().withName("Mix").withID(140).asPercent().withDefault(0.5))
+          replace(md<100>().asPercent()), brightness(md<110>().asPercent()),
+          detune(md<120>().asPercent()), bigness(md<130>().asPercent()), mix(md<140>().asPercent())
     {
         this->pushSingleParam(&replace);
         this->pushSingleParam(&brightness);
         this->pushSingleParam(&detune);
         this->pushSingleParam(&bigness);
         this->pushSingleParam(&mix);
+        assert(shared::paramsMatchTable(params, paramTable));
 
         onResetToInit = [](auto &patch)
         {
@@ -14,11 +14,13 @@
 
 #include "shared/processor_shim.h"
 
-#include "galaxy_engine.hpp"
+#include "dispatched_engine.h"
 #include "galaxy.h"
 #include "patch.h"
 #include "editor.h"
 
+#include <limits>
+
 namespace sapphire_plugins::galaxy
 {
 
@@ -48,50 +50,54 @@ struct GalaxyClap : public shared::ProcessorShim<GalaxyClap>
     using param_t = Param;
     static constexpr bool hasStereoInput{true};
     static constexpr bool hasStereoOutput{true};
-
-    std::unique_ptr<Sapphire::Galaxy::Engine> engine;
+    static constexpr bool supportsOversampling{false};
+    static constexpr bool supportsFixedEngineRate{false};
+    /*
+     * Replace sets how much of the tank new input overwrites. At the bottom of its range
+     * nothing is replaced and the tank feeds back on itself, so the reverb holds
+     * indefinitely and we report an endless tail. Elsewhere the tail is a cap rather
+     * than a measurement, long enough for the slowest settings we expect to bounce.
+     */
+    static constexpr double tailSeconds{10.0};
+    static constexpr float endlessReplace{0.01f};
+
+    std::unique_ptr<DispatchedEngine> engine;
     Patch patch;
-    size_t blockPos{0};
 
-    GalaxyClap(const clap_host *h) : shared::ProcessorShim<GalaxyClap>(getDescriptor(), h)
+    GalaxyClap(const clap_host *h) : shared::ProcessorShim<GalaxyClap>(getDescriptor(), h) {}
+
+    void createEngine() { engine = makeDispatchedEngine(); }
+    void releaseEngine() { engine.reset(); }
+
+    void bindEngineSetters()
+    {
+        bindParamToEngine(patch.replace, [](auto &c, float v) { c.engine->setReplace(v); });
+        bindParamToEngine(patch.brightness, [](auto &c, float v) { c.engine->setBrightness(v); });
+        bindParamToEngine(patch.detune, [](auto &c, float v) { c.engine->setDetune(v); });
+        bindParamToEngine(patch.bigness, [](auto &c, float v) { c.engine->setBigness(v); });
+        bindParamToEngine(patch.mix, [](auto &c, float v) { c.engine->setMix(v); });
+    }
+
+    uint32_t tailSamples() const
+    {
+        if (patch.replace.value <= endlessReplace)
+            return std::numeric_limits<uint32_t>::max();
+        return (uint32_t)(sampleRate * tailSeconds);
+    }
+
+    void processEngineBlock(float **in, float **out, uint32_t offset, uint32_t frames,
+                            uint32_t)
     {
-        engine = std::make_unique<Sapphire::Galaxy::Engine>();
+        engine->process(engineSampleRate, in[0] + offset, in[1] + offset, out[0] + offset,
+                        out[1] + offset, frames);
     }
 
-    clap_process_status process(const clap_process *process) noexcept override
+    void reset() noexcept override
     {
-        auto ev = process->in_events;
-        auto outq = process->out_events;
-
-        float **in = process->audio_inputs[0].data32;
-        float **out = process->audio_outputs[0].data32;
-
-        shared::processUIQueueFromAudio(this, outq);
-
-        startProcessEventTraversal(ev);
-
-        for (auto s = 0U; s < process->frames_count; ++s)
-        {
-            if (blockPos == 0)
-            {
-                processEventsUpTo(s, ev);
-
-                for (auto &[i, p] : patch.paramMap)
-                    p->lag.process();
-                engine->setReplace(patch.replace.lag.v);
-                engine->setBrightness(patch.brightness.lag.v);
-                engine->setDetune(patch.detune.lag.v);
-                engine->setBigness(patch.bigness.lag.v);
-                engine->setMix(patch.mix.lag.v);
-            }
-            engine->process(sampleRate, in[0][s], in[1][s], out[0][s], out[1][s]);
-            blockPos = (blockPos + 1) & (smoothingBlock - 1);
-        }
-
-        processEventsUpTo(process->frames_count, ev);
-        return CLAP_PROCESS_CONTINUE;
+        engine->initialize();
+        smoothing.markAllChanged();
+        quietOutputSamples = 0;
     }
-    void reset() noexcept override { engine->initialize(); }
 
     bool handleNonParamEvent(const clap_event_header_t *nextEvent) { return false; }
 };
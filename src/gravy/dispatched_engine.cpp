@@ -0,0 +1,57 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+// Built once per cpu level; see elastika/dispatched_engine.cpp
+
+#include "gravy/dispatched_engine.h"
+#include "gravy_engine.hpp"
+
+#ifndef SAPPHIRE_SIMD_NS
+#error "dispatched_engine.cpp needs SAPPHIRE_SIMD_NS from the build"
+#endif
+
+namespace sapphire_plugins::gravy::SAPPHIRE_SIMD_NS
+{
+namespace
+{
+struct Engine : DispatchedEngine
+{
+    Sapphire::Gravy::GravyEngine<engineChannels> eng;
+
+    void setFrequency(float v) override { eng.setFrequency(v); }
+    void setResonance(float v) override { eng.setResonance(v); }
+    void setMix(float v) override { eng.setMix(v); }
+    void setGain(float v) override { eng.setGain(v); }
+    void setFilterMode(int mode) override { eng.setFilterMode((Sapphire::FilterMode)mode); }
+    void initialize() override { eng.initialize(); }
+
+    void process(double sampleRate, float **in, float **out, uint32_t offset, uint32_t frames,
+                 uint32_t chans) override
+    {
+        for (auto s = 0U; s < frames; ++s)
+        {
+            float inf[engineChannels];
+            float outf[engineChannels];
+            for (auto c = 0U; c < chans; ++c)
+                inf[c] = in[c][offset + s];
+            eng.process(sampleRate, chans, inf, outf);
+            for (auto c = 0U; c < chans; ++c)
+                out[c][offset + s] = outf[c];
+        }
+    }
+};
+} // namespace
+
+std::unique_ptr<DispatchedEngine> makeEngine() { return std::make_unique<Engine>(); }
+} // namespace sapphire_plugins::gravy::SAPPHIRE_SIMD_NS
@@ -0,0 +1,71 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#ifndef SAPPHIRE_PLUGINS_GRAVY_DISPATCHED_ENGINE_H
+#define SAPPHIRE_PLUGINS_GRAVY_DISPATCHED_ENGINE_H
+
+#include <cstdint>
+#include <memory>
+
+#include "shared/simd_dispatch.h"
+
+namespace sapphire_plugins::gravy
+{
+/*
+ * The Gravy filter, built once per cpu level from dispatched_engine.cpp. It always has
+ * room for engineChannels channels and runs however many the port config uses.
+ */
+struct DispatchedEngine
+{
+    static constexpr uint32_t engineChannels{8};
+
+    virtual ~DispatchedEngine() = default;
+
+    virtual void setFrequency(float v) = 0;
+    virtual void setResonance(float v) = 0;
+    virtual void setMix(float v) = 0;
+    virtual void setGain(float v) = 0;
+    virtual void setFilterMode(int mode) = 0;
+    virtual void initialize() = 0;
+
+    // Channel c reads in[c][offset, offset + frames) and writes the same range of out[c]
+    virtual void process(double sampleRate, float **in, float **out, uint32_t offset,
+                         uint32_t frames, uint32_t chans) = 0;
+};
+
+#define SAPPHIRE_DECLARE_GRAVY_ENGINE(ns)                                                          \
+    namespace ns                                                                                   \
+    {                                                                                              \
+    std::unique_ptr<DispatchedEngine> makeEngine();                                                \
+    }
+
+SAPPHIRE_DECLARE_GRAVY_ENGINE(simd_generic)
+#if SAPPHIRE_SIMD_X86
+SAPPHIRE_DECLARE_GRAVY_ENGINE(simd_avx2)
+SAPPHIRE_DECLARE_GRAVY_ENGINE(simd_avx512)
+#endif
+
+inline std::unique_ptr<DispatchedEngine> makeDispatchedEngine()
+{
+#if SAPPHIRE_SIMD_X86
+    static constexpr decltype(&simd_generic::makeEngine) byLevel[]{
+        simd_generic::makeEngine, simd_avx2::makeEngine, simd_avx512::makeEngine};
+#else
+    static constexpr decltype(&simd_generic::makeEngine) byLevel[]{simd_generic::makeEngine};
+#endif
+    return shared::forActiveLevel(byLevel)();
+}
+} // namespace sapphire_plugins::gravy
+
+#endif // DISPATCHED_ENGINE_H
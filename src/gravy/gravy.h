@@ -21,6 +21,11 @@ namespace sapphire_plugins::gravy
 const clap_plugin *makePlugin(const clap_host *);
 const clap_plugin_descriptor *getDescriptor();
 
+#if SAPPHIRE_BENCH_POLICY_VARIANTS
+// Gravy with stepped smoothing, which the bench compares against the shipping policy
+const clap_plugin *makeSteppedPluginForBench(const clap_host *);
+#endif
+
 static constexpr const char *pluginId{"org.sapphire_plugin.gravy"};
 
 } // namespace sapphire_plugins::gravy
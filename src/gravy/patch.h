@@ -24,6 +24,7 @@
 #include "gravy.h"
 #include "sst/plugininfra/patch-support/patch_base.h"
 #include "shared/param_with_lag.h"
+#include "shared/param_table.h"
 
 namespace sapphire_plugins::gravy
 {
@@ -40,29 +41,26 @@ struct Patch : pats::PatchBase<Patch, Param>
     char name[256]{""};
 
     static constexpr uint32_t floatFlags{CLAP_PARAM_IS_AUTOMATABLE};
+    static constexpr uint32_t steppedFlags{floatFlags | CLAP_PARAM_IS_STEPPED};
 
-    static md_t floatMd() { return md_t().asFloat().withFlags(floatFlags); }
-    static md_t intMd() { return md_t().asInt().withFlags(floatFlags | CLAP_PARAM_IS_STEPPED); }
+    static constexpr shared::ParamTable<5> paramTable{{{
+        {100, "Frequency", -5, 5, 0, floatFlags},
+        {110, "Resonance", 0, 1, 0.70710678f, floatFlags},
+        {120, "Mix", 0, 1, 1, floatFlags},
+        {130, "Gain", 0, 1, 0.5, floatFlags},
+        {140, "Mode", 0, 2, 1, steppedFlags},
+    }}};
+
+    template <clap_id id> static md_t md() { return shared::metaFor<paramTable, id>(); }
 
     Param frequency, resonance, mix, gain, mode;
 
     Patch()
-        : pats::PatchBase<Patch, Param>(), frequency(floatMd()
-                                                         .withName("Frequency")
-                                                         .withID(100)
-                                                         .withRange(-5, 5)
-                                                         .withDefault(0)
-                                                         .withLinearScaleFormatting("")),
-          resonance(
-              floatMd().withName("Resonance").withID(110).asPercent().withDefault(sqrt(2) / 2.0)),
-          mix(floatMd().withName("Mix").withID(120).asPercent().withDefault(1)),
-          gain(floatMd().withName("Gain").withID(130).asPercent().withDefault(0.5)),
-          mode(intMd()
-                   .withName("Mode")
-                   .withID(140)
-                   .withRange(0, 2)
-                   .withDefault(1)
-                   .withUnorderedMapFormatting({{0, "LowPass"}, {1, "BandPass"}, {2, "HighPass"}}))
+        : pats::PatchBase<Patch, Param>(), frequency(md<100>().withLinearScaleFormatting("")),
+          resonance(md<110>().asPercent()), mix(md<120>().asPercent()),
+          gain(md<130>().asPercent()),
+          mode(md<140>().withUnorderedMapFormatting(
+              {{0, "LowPass"}, {1, "BandPass"}, {2, "HighPass"}}))
 
     {
         this->pushSingleParam(&frequency);
@@ -70,6 +68,7 @@ struct Patch : pats::PatchBase<Patch, Param>
         this->pushSingleParam(&mix);
         this->pushSingleParam(&gain);
         this->pushSingleParam(&mode);
+        assert(shared::paramsMatchTable(params, paramTable));
 
         onResetToInit = [](auto &patch)
         {
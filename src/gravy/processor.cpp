@@ -14,7 +14,7 @@
 
 #include "shared/processor_shim.h"
 
-#include "gravy_engine.hpp"
+#include "dispatched_engine.h"
 #include "gravy.h"
 #include "patch.h"
 #include "editor.h"
@@ -41,68 +41,79 @@ const clap_plugin_descriptor *getDescriptor()
     return &desc;
 }
 
-struct GravyClap : public shared::ProcessorShim<GravyClap>
+/*
+ * Gravy ships with sample accurate smoothing, since its frequency zippers badly when
+ * stepped. The policy is a template parameter only so the benchmark harness can time
+ * the same filter under both policies.
+ */
+template <typename SmoothingPolicy>
+struct GravyClapT : public shared::ProcessorShim<GravyClapT<SmoothingPolicy>, SmoothingPolicy, 8>
 {
+    using base_t = shared::ProcessorShim<GravyClapT<SmoothingPolicy>, SmoothingPolicy, 8>;
+    using base_t::bindParamToEngine;
+    using base_t::engineSampleRate;
+    using base_t::maxPortChannels;
+    using base_t::quietOutputSamples;
+    using base_t::smoothing;
+
     using editor_t = GravyEditor;
     using patch_t = Patch;
     using param_t = Param;
     static constexpr bool hasStereoInput{true};
     static constexpr bool hasStereoOutput{true};
+    static constexpr bool supportsOversampling{false};
+    static constexpr bool supportsFixedEngineRate{false};
+    static constexpr double tailSeconds{0.1};
 
-    std::unique_ptr<Sapphire::Gravy::GravyEngine<2>> engine;
+    // One engine across every channel of the selected port config
+    std::unique_ptr<DispatchedEngine> engine;
+    static_assert(DispatchedEngine::engineChannels == maxPortChannels);
     Patch patch;
-    size_t blockPos{0};
 
-    GravyClap(const clap_host *h) : shared::ProcessorShim<GravyClap>(getDescriptor(), h)
+    GravyClapT(const clap_host *h) : base_t(getDescriptor(), h) {}
+
+    void createEngine() { engine = makeDispatchedEngine(); }
+    void releaseEngine() { engine.reset(); }
+
+    void bindEngineSetters()
     {
-        engine = std::make_unique<Sapphire::Gravy::GravyEngine<2>>();
+        bindParamToEngine(patch.frequency, [](auto &c, float v) { c.engine->setFrequency(v); });
+        bindParamToEngine(patch.resonance, [](auto &c, float v) { c.engine->setResonance(v); });
+        bindParamToEngine(patch.mix, [](auto &c, float v) { c.engine->setMix(v); });
+        bindParamToEngine(patch.gain, [](auto &c, float v) { c.engine->setGain(v); });
+        bindParamToEngine(patch.mode,
+                          [](auto &c, float v) { c.engine->setFilterMode((int)std::round(v)); });
     }
 
-    clap_process_status process(const clap_process *process) noexcept override
+    void processEngineBlock(float **in, float **out, uint32_t offset, uint32_t frames,
+                            uint32_t chans)
     {
-        auto ev = process->in_events;
-        auto outq = process->out_events;
-        auto sz = ev->size(ev);
-
-        float **in = process->audio_inputs[0].data32;
-        float **out = process->audio_outputs[0].data32;
-
-        shared::processUIQueueFromAudio(this, outq);
-
-        startProcessEventTraversal(ev);
-
-        for (auto s = 0U; s < process->frames_count; ++s)
-        {
-            if (blockPos == 0)
-            {
-                processEventsUpTo(s, ev);
-                for (auto &[i, p] : patch.paramMap)
-                    p->lag.process();
-                engine->setFrequency(patch.frequency.lag.v);
-                engine->setResonance(patch.resonance.lag.v);
-                engine->setMix(patch.mix.lag.v);
-                engine->setGain(patch.gain.lag.v);
-                engine->setFilterMode((Sapphire::FilterMode)(int)std::round(patch.mode.value));
-            }
-            float inf[2]{in[0][s], in[1][s]};
-            float outf[2];
-            engine->process(sampleRate, 2, inf, outf);
-            out[0][s] = outf[0];
-            out[1][s] = outf[1];
-            blockPos = (blockPos + 1) & (smoothingBlock - 1);
-        }
-
-        processEventsUpTo(process->frames_count, ev);
-        return CLAP_PROCESS_CONTINUE;
+        engine->process(engineSampleRate, in, out, offset, frames, chans);
+    }
+
+    void reset() noexcept override
+    {
+        engine->initialize();
+        smoothing.markAllChanged();
+        quietOutputSamples = 0;
     }
-    void reset() noexcept override { engine->initialize(); }
     bool handleNonParamEvent(const clap_event_header_t *nextEvent) { return false; }
 };
 
+using GravyClap = GravyClapT<shared::SampleAccurateSmoothing>;
+
 const clap_plugin *makePlugin(const clap_host *h)
 {
     auto res = new GravyClap(h);
     return res->clapPlugin();
 }
 
+#if SAPPHIRE_BENCH_POLICY_VARIANTS
+const clap_plugin *makeSteppedPluginForBench(const clap_host *h)
+{
+    auto res = new GravyClapT<shared::SteppedSmoothing>(h);
+    return res->clapPlugin();
+}
+#endif
+
 } // namespace sapphire_plugins::gravy
@@ -0,0 +1,131 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#include "allocation_tally.h"
+
+#if SAPPHIRE_MEMORY_REPORT
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace sapphire_plugins::shared
+{
+namespace
+{
+thread_local AllocationTally *activeTally{nullptr};
+
+/*
+ * Every block carries a header just below the pointer we hand out, with its size and
+ * the tally which was open when it was allocated. A free only counts against that
+ * tally if it is still the innermost one open on this thread.
+ */
+struct alignas(alignof(std::max_align_t)) BlockHeader
+{
+    size_t size;
+    AllocationTally *tally;
+};
+static constexpr size_t headerSize{sizeof(BlockHeader)};
+
+void *track(void *block, size_t offset, size_t size)
+{
+    auto *res = static_cast<char *>(block) + offset;
+    auto *h = reinterpret_cast<BlockHeader *>(res) - 1;
+    h->size = size;
+    h->tally = activeTally;
+    if (activeTally)
+        activeTally->bytes += (int64_t)size;
+    return res;
+}
+
+void untrack(void *ptr)
+{
+    auto *h = static_cast<BlockHeader *>(ptr) - 1;
+    if (h->tally && h->tally == activeTally)
+        activeTally->bytes -= (int64_t)h->size;
+}
+
+void *alignedBlock(size_t size, size_t align)
+{
+#if defined(_MSC_VER)
+    return _aligned_malloc(size, align);
+#else
+    return std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+}
+
+void freeAlignedBlock(void *block)
+{
+#if defined(_MSC_VER)
+    _aligned_free(block);
+#else
+    std::free(block);
+#endif
+}
+} // namespace
+
+AllocationTally::AllocationTally() : previous(activeTally) { activeTally = this; }
+
+void AllocationTally::stop()
+{
+    if (!open)
+        return;
+    open = false;
+    activeTally = previous;
+}
+} // namespace sapphire_plugins::shared
+
+namespace spsh = sapphire_plugins::shared;
+
+void *operator new(std::size_t size)
+{
+    auto *block = std::malloc(size + spsh::headerSize);
+    if (!block)
+        throw std::bad_alloc();
+    return spsh::track(block, spsh::headerSize, size);
+}
+
+void *operator new(std::size_t size, std::align_val_t al)
+{
+    // The header sits in the slack below the aligned pointer
+    auto align = std::max((size_t)al, spsh::headerSize);
+    auto *block = spsh::alignedBlock(size + align, align);
+    if (!block)
+        throw std::bad_alloc();
+    return spsh::track(block, align, size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    if (!ptr)
+        return;
+    spsh::untrack(ptr);
+    std::free(static_cast<char *>(ptr) - spsh::headerSize);
+}
+
+void operator delete(void *ptr, std::align_val_t al) noexcept
+{
+    if (!ptr)
+        return;
+    spsh::untrack(ptr);
+    auto align = std::max((size_t)al, spsh::headerSize);
+    spsh::freeAlignedBlock(static_cast<char *>(ptr) - align);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept { operator delete(ptr); }
+void operator delete(void *ptr, std::size_t, std::align_val_t al) noexcept
+{
+    operator delete(ptr, al);
+}
+#endif
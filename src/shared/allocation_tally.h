@@ -0,0 +1,54 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#ifndef SAPPHIRE_PLUGINS_SHARED_ALLOCATION_TALLY_H
+#define SAPPHIRE_PLUGINS_SHARED_ALLOCATION_TALLY_H
+
+#include <cstdint>
+
+namespace sapphire_plugins::shared
+{
+/*
+ * Counts the heap bytes the current thread allocates, net of what it frees again, while
+ * the tally is open. It exists for the memory report in activate, which wants what an
+ * engine really costs, delay lines and meshes included, rather than sizeof. Counting
+ * means replacing the global operator new, so it is only built when the
+ * SAPPHIRE_MEMORY_REPORT option is on. Otherwise a tally is free and always reads zero.
+ */
+#if SAPPHIRE_MEMORY_REPORT
+struct AllocationTally
+{
+    AllocationTally();
+    ~AllocationTally() { stop(); }
+    AllocationTally(const AllocationTally &) = delete;
+    AllocationTally &operator=(const AllocationTally &) = delete;
+
+    void stop();
+
+    int64_t bytes{0};
+
+  private:
+    AllocationTally *previous{nullptr};
+    bool open{true};
+};
+#else
+struct AllocationTally
+{
+    void stop() {}
+    int64_t bytes{0};
+};
+#endif
+} // namespace sapphire_plugins::shared
+
+#endif // ALLOCATION_TALLY_H
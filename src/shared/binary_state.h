@@ -0,0 +1,209 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#ifndef SAPPHIRE_PLUGINS_SHARED_BINARY_STATE_H
+#define SAPPHIRE_PLUGINS_SHARED_BINARY_STATE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <clap/clap.h>
+
+namespace sapphire_plugins::shared
+{
+/*
+ * Our state chunk is a fixed header followed by an (id, value) pair per param:
+ *
+ *   char[4]  magic "SPst"
+ *   uint32   binaryStateVersion
+ *   uint32   Patch::patchVersion
+ *   uint32   param count
+ *   char[256] patch name
+ *   { uint32 id; float value; } x count
+ *
+ * All little endian. Keying by id means adding or removing params doesn't change the
+ * format. Streams which don't start with the magic are the older tinyxml patches, which
+ * the caller hands to the xml reader, and the next save writes them back out in this form.
+ */
+static constexpr char binaryStateMagic[4]{'S', 'P', 's', 't'};
+static constexpr uint32_t binaryStateVersion{1};
+
+namespace detail
+{
+inline void appendU32(std::vector<uint8_t> &buf, uint32_t v)
+{
+    for (int i = 0; i < 4; ++i)
+        buf.push_back((uint8_t)(v >> (8 * i)));
+}
+
+inline uint32_t readU32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+} // namespace detail
+
+inline bool readWholeStream(const clap_istream *istream, std::vector<uint8_t> &buf)
+{
+    buf.clear();
+    uint8_t chunk[4096];
+    while (true)
+    {
+        auto rd = istream->read(istream, chunk, sizeof(chunk));
+        if (rd < 0)
+            return false;
+        if (rd == 0)
+            return true;
+        buf.insert(buf.end(), chunk, chunk + rd);
+    }
+}
+
+inline bool writeWholeStream(const clap_ostream *ostream, const std::vector<uint8_t> &buf)
+{
+    size_t written{0};
+    while (written < buf.size())
+    {
+        auto wr = ostream->write(ostream, buf.data() + written, buf.size() - written);
+        if (wr <= 0)
+            return false;
+        written += wr;
+    }
+    return true;
+}
+
+inline bool isBinaryState(const std::vector<uint8_t> &buf)
+{
+    return buf.size() >= sizeof(binaryStateMagic) &&
+           std::memcmp(buf.data(), binaryStateMagic, sizeof(binaryStateMagic)) == 0;
+}
+
+/*
+ * Presents an in-memory buffer as a clap_istream, so state we've already read can be
+ * handed on to readers which want a stream.
+ */
+struct MemoryIStream
+{
+    clap_istream stream;
+    const std::vector<uint8_t> &buf;
+    size_t pos{0};
+
+    explicit MemoryIStream(const std::vector<uint8_t> &b) : buf(b)
+    {
+        stream.ctx = this;
+        stream.read = [](const clap_istream *s, void *dest, uint64_t size) -> int64_t
+        {
+            auto self = static_cast<MemoryIStream *>(s->ctx);
+            auto n = std::min<uint64_t>(size, self->buf.size() - self->pos);
+            std::memcpy(dest, self->buf.data() + self->pos, n);
+            self->pos += n;
+            return (int64_t)n;
+        };
+    }
+
+    const clap_istream *get() const { return &stream; }
+};
+
+// values, if given, stand in for the params' own values and are indexed like patch.params
+template <typename Patch>
+void patchToBinary(const Patch &patch, std::vector<uint8_t> &buf, const float *values = nullptr)
+{
+    buf.clear();
+    buf.insert(buf.end(), binaryStateMagic, binaryStateMagic + sizeof(binaryStateMagic));
+    detail::appendU32(buf, binaryStateVersion);
+    detail::appendU32(buf, Patch::patchVersion);
+    detail::appendU32(buf, (uint32_t)patch.params.size());
+
+    char name[sizeof(patch.name)]{};
+    strncpy(name, patch.name, sizeof(name) - 1);
+    buf.insert(buf.end(), name, name + sizeof(name));
+
+    for (auto i = 0U; i < patch.params.size(); ++i)
+    {
+        const auto *p = patch.params[i];
+        float value = values ? values[i] : p->value;
+        uint32_t bits;
+        static_assert(sizeof(bits) == sizeof(value));
+        std::memcpy(&bits, &value, sizeof(bits));
+        detail::appendU32(buf, p->meta.id);
+        detail::appendU32(buf, bits);
+    }
+}
+
+/*
+ * Params the chunk doesn't mention go back to their defaults and ids we no longer know
+ * are skipped. Values are clamped to the current range.
+ */
+template <typename Patch> bool binaryToPatch(const std::vector<uint8_t> &buf, Patch &patch)
+{
+    constexpr size_t headerSize = sizeof(binaryStateMagic) + 3 * 4 + sizeof(patch.name);
+    if (!isBinaryState(buf) || buf.size() < headerSize)
+        return false;
+
+    auto *p = buf.data() + sizeof(binaryStateMagic);
+    auto version = detail::readU32(p);
+    auto patchVersion = detail::readU32(p + 4);
+    auto count = detail::readU32(p + 8);
+    p += 12;
+    if (version > binaryStateVersion || buf.size() < headerSize + (size_t)count * 8)
+        return false;
+
+    std::memcpy(patch.name, p, sizeof(patch.name));
+    patch.name[sizeof(patch.name) - 1] = 0;
+    p += sizeof(patch.name);
+
+    for (auto *par : patch.params)
+        par->value = par->meta.defaultVal;
+
+    for (auto i = 0U; i < count; ++i, p += 8)
+    {
+        auto idx = Patch::paramTable.indexOf(detail::readU32(p));
+        if (idx >= Patch::paramTable.size())
+            continue;
+
+        auto bits = detail::readU32(p + 4);
+        float v;
+        std::memcpy(&v, &bits, sizeof(v));
+        if (!std::isfinite(v))
+            continue;
+
+        auto *par = patch.params[idx];
+        if (patchVersion != Patch::patchVersion)
+            v = patch.migrateParamValueFromVersion(par, v, patchVersion);
+        par->value = std::clamp(v, par->meta.minVal, par->meta.maxVal);
+    }
+
+    if (patchVersion != Patch::patchVersion)
+        patch.migratePatchFromVersion(patchVersion);
+
+    return true;
+}
+
+/*
+ * Reads a saved state into patch. Binary chunks are parsed here and anything else is an
+ * older xml patch, which goes to readXml(istream, patch) as a stream over the same bytes.
+ */
+template <typename Patch, typename XmlReader>
+bool stateToPatch(const std::vector<uint8_t> &buf, Patch &patch, XmlReader &&readXml)
+{
+    if (isBinaryState(buf))
+        return binaryToPatch(buf, patch);
+
+    MemoryIStream mis(buf);
+    return readXml(mis.get(), patch);
+}
+} // namespace sapphire_plugins::shared
+
+#endif // BINARY_STATE_H
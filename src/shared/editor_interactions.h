@@ -15,8 +15,10 @@
 #ifndef SAPPHIRE_PLUGINS_SHARED_EDITOR_INTERACTIONS_H
 #define SAPPHIRE_PLUGINS_SHARED_EDITOR_INTERACTIONS_H
 
+#include <cstdint>
 #include "sapphire_panel.hpp"
 #include "tooltip.h"
+#include "shared/editor_queues.h"
 #include <sst/basic-blocks/params/ParamMetadata.h>
 
 namespace sapphire_plugins::shared
@@ -28,34 +30,30 @@ template <typename Editor> struct IdleTimer : juce::Timer
     void timerCallback() override { editor.idle(); }
 };
 
-struct AudioToUIMsg
+template <typename Ed, typename Param>
+inline void updateEditorParam(Ed &editor, Param *p, float val)
 {
-    enum Action : uint32_t
-    {
-        UPDATE_PARAM,
-        UPDATE_VU,
-    } action;
-    uint32_t paramId{0};
-    float value{0}, value2{0};
-};
-struct UIToAudioMsg
-{
-    enum Action : uint32_t
+    if (!p)
+        return;
+
+    p->value = val;
+    auto val01 = (val - p->meta.minVal) / (p->meta.maxVal - p->meta.minVal);
+    auto sbi = editor.sliderByID.find(p->meta.id);
+    if (sbi != editor.sliderByID.end() && sbi->second)
     {
-        REQUEST_REFRESH,
-        SET_PARAM,
-        BEGIN_EDIT,
-        END_EDIT,
-        EDITOR_ATTACH_DETATCH, // paramid is true for attach and false for detach
-    } action;
-    uint32_t paramId{0};
-    float value{0};
-};
-using audioToUIQueue_t = sst::cpputils::SimpleRingBuffer<AudioToUIMsg, 1024 * 16>;
-using uiToAudioQueue_T = sst::cpputils::SimpleRingBuffer<UIToAudioMsg, 1024 * 64>;
+        sbi->second->setValue(val01, juce::dontSendNotification);
+    }
+}
 
 template <typename Ed> inline void drainQueueFromUI(Ed &editor)
 {
+    editor.paramMailbox.drain(
+        [&editor](uint32_t idx, float val)
+        {
+            if (idx < editor.patchCopy.params.size())
+                updateEditorParam(editor, editor.patchCopy.params[idx], val);
+        });
+
     auto aum = editor.audioToUI.pop();
     while (aum.has_value())
     {
@@ -63,19 +61,7 @@ template <typename Ed> inline void drainQueueFromUI(Ed &editor)
         {
         case AudioToUIMsg::UPDATE_PARAM:
         {
-            auto pid = aum->paramId;
-            auto val = aum->value;
-            auto p = editor.patchCopy.paramMap.at(pid);
-            if (p)
-            {
-                p->value = val;
-                auto val01 = (val - p->meta.minVal) / (p->meta.maxVal - p->meta.minVal);
-                auto sbi = editor.sliderByID.find(pid);
-                if (sbi != editor.sliderByID.end() && sbi->second)
-                {
-                    sbi->second->setValue(val01, juce::dontSendNotification);
-                }
-            }
+            updateEditorParam(editor, editor.patchCopy.paramMap.at(aum->paramId), aum->value);
         }
         break;
         case AudioToUIMsg::UPDATE_VU:
@@ -85,10 +71,34 @@ template <typename Ed> inline void drainQueueFromUI(Ed &editor)
     }
 }
 
+template <typename Ed> inline void attachEditor(Ed &editor)
+{
+    editor.editorQueues.editorAlive = true;
+    editor.uiToAudio.push({UIToAudioMsg::EDITOR_ATTACH_DETATCH, true});
+}
+
+template <typename Ed> inline void detachEditor(Ed &editor)
+{
+    editor.uiToAudio.push({UIToAudioMsg::EDITOR_ATTACH_DETATCH, false});
+    editor.editorQueues.editorAlive = false;
+
+    // Don't wait on the audio thread to see the detach, since a sleeping or inactive
+    // instance may never process it
+    if (editor.editorQueues.requestRelease)
+        editor.editorQueues.requestRelease();
+}
+
 template <typename Processor>
 void processUIQueueFromAudio(Processor *proc, const clap_output_events_t *outq)
 {
-    auto uiM = proc->uiToAudio.pop();
+    auto *queues = proc->acquireEditorQueues();
+    if (!queues)
+    {
+        proc->isEditorAttached = false;
+        return;
+    }
+
+    auto uiM = queues->uiToAudio.pop();
     while (uiM.has_value())
     {
         switch (uiM->action)
@@ -101,10 +111,12 @@ void processUIQueueFromAudio(Processor *proc, const clap_output_events_t *outq)
         break;
         case UIToAudioMsg::SET_PARAM:
         {
-            auto dest = proc->patch.paramMap.at(uiM->paramId);
+            auto dest = proc->paramFromId(uiM->paramId);
+            if (!dest)
+                break;
 
             dest->value = uiM->value;
-            dest->lag.setTarget(uiM->value);
+            dest->setTarget(uiM->value);
 
             clap_event_param_value_t p;
             p.header.size = sizeof(clap_event_param_value_t);
@@ -143,17 +155,23 @@ void processUIQueueFromAudio(Processor *proc, const clap_output_events_t *outq)
         case UIToAudioMsg::EDITOR_ATTACH_DETATCH:
         {
             auto was = proc->isEditorAttached;
+            auto is = uiM->paramId != 0;
 
-            proc->isEditorAttached = uiM->paramId;
-            if (!was && proc->isEditorAttached)
+            proc->isEditorAttached = is;
+            if (!was && is)
             {
                 proc->pushFullUIRefresh();
             }
+            if (!is)
+            {
+                proc->requestEditorQueueRelease();
+            }
         }
         break;
         }
-        uiM = proc->uiToAudio.pop();
+        uiM = queues->uiToAudio.pop();
     }
+    proc->releaseEditorQueues();
 }
 
 template <typename Editor> inline void setTooltipValues(Editor *e, uint32_t id)
@@ -0,0 +1,108 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#ifndef SAPPHIRE_PLUGINS_SHARED_EDITOR_QUEUES_H
+#define SAPPHIRE_PLUGINS_SHARED_EDITOR_QUEUES_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include "shared/smoothing_bank.h"
+#include "shared/spsc_queue.h"
+
+namespace sapphire_plugins::shared
+{
+struct AudioToUIMsg
+{
+    enum Action : uint32_t
+    {
+        UPDATE_PARAM,
+        UPDATE_VU,
+    } action;
+    uint32_t paramId{0};
+    float value{0}, value2{0};
+};
+struct UIToAudioMsg
+{
+    enum Action : uint32_t
+    {
+        REQUEST_REFRESH,
+        SET_PARAM,
+        BEGIN_EDIT,
+        END_EDIT,
+        EDITOR_ATTACH_DETATCH, // paramid is true for attach and false for detach
+    } action;
+    uint32_t paramId{0};
+    float value{0};
+};
+
+/*
+ * The message rings between an editor and the audio thread. Each plugin picks its own
+ * capacities, and the processor only allocates them while an editor is open, since an
+ * instance with its window closed has nothing to say to a UI. Param values travel
+ * through the ParamMailbox instead, so these only need to absorb slider gestures
+ * between two audio blocks. editorAlive is touched only on the main thread, and
+ * requestRelease asks the processor for a main thread callback to free the queues.
+ */
+struct EditorQueuesBase
+{
+    virtual ~EditorQueuesBase() = default;
+    bool editorAlive{false};
+    std::function<void()> requestRelease;
+};
+
+template <size_t audioToUICapacity, size_t uiToAudioCapacity>
+struct EditorQueues : EditorQueuesBase
+{
+    using audioToUI_t = SpscQueue<AudioToUIMsg, audioToUICapacity>;
+    using uiToAudio_t = SpscQueue<UIToAudioMsg, uiToAudioCapacity>;
+
+    audioToUI_t audioToUI;
+    uiToAudio_t uiToAudio;
+};
+
+/*
+ * Param values headed to the editor. Rather than queueing every automation point, the
+ * audio thread overwrites a per-param slot and sets a dirty bit, and the editor picks up
+ * only the latest value of each dirty param when it idles. Slots are indexed by the
+ * param's dense index, which is its position in patch.params.
+ */
+struct ParamMailbox
+{
+    static constexpr uint32_t maxParams{SmoothingBank::maxParams};
+
+    // The editor swaps dirty at 60Hz, so keep it off the line the audio thread writes values to
+    alignas(cacheLineSize) std::atomic<float> values[maxParams]{};
+    alignas(cacheLineSize) std::atomic<uint64_t> dirty{0};
+
+    void post(uint32_t index, float value)
+    {
+        values[index].store(value, std::memory_order_relaxed);
+        dirty.fetch_or((uint64_t)1 << index, std::memory_order_release);
+    }
+
+    template <typename F> void drain(F &&f)
+    {
+        auto d = dirty.exchange(0, std::memory_order_acquire);
+        while (d)
+        {
+            auto idx = lowestSetBit(d);
+            d &= d - 1;
+            f(idx, values[idx].load(std::memory_order_relaxed));
+        }
+    }
+};
+} // namespace sapphire_plugins::shared
+
+#endif // EDITOR_QUEUES_H
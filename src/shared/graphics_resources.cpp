@@ -16,6 +16,9 @@
 #include "configuration.h"
 
 #include <cmrc/cmrc.hpp>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 CMRC_DECLARE(sapphire_graphics);
 
@@ -43,6 +46,55 @@ std::optional<std::string> getSvgForPath(const std::string &path)
     ;
 }
 
+namespace
+{
+struct PinnedGraphics
+{
+    std::vector<std::shared_ptr<const void>> resources;
+};
+std::weak_ptr<PinnedGraphics> pinnedGraphics;
+} // namespace
+
+std::shared_ptr<const void> retainGraphicsResources()
+{
+    auto res = pinnedGraphics.lock();
+    if (!res)
+    {
+        res = std::make_shared<PinnedGraphics>();
+        pinnedGraphics = res;
+    }
+    return res;
+}
+
+void pinGraphicsResource(std::shared_ptr<const void> resource)
+{
+    if (auto pinned = pinnedGraphics.lock())
+        pinned->resources.push_back(std::move(resource));
+}
+
+std::shared_ptr<const juce::Drawable> getSharedDrawable(const std::string &path)
+{
+    static std::mutex cacheMutex;
+    static std::unordered_map<std::string, std::weak_ptr<const juce::Drawable>> cache;
+
+    std::lock_guard<std::mutex> g(cacheMutex);
+    auto &entry = cache[path];
+    if (auto res = entry.lock())
+        return res;
+
+    auto svg = getSvgForPath(path);
+    if (!svg.has_value())
+        return nullptr;
+    auto xml = juce::XmlDocument::parse(*svg);
+    if (!xml)
+        return nullptr;
+
+    std::shared_ptr<const juce::Drawable> res = juce::Drawable::createFromSVG(*xml);
+    entry = res;
+    pinGraphicsResource(res);
+    return res;
+}
+
 PanelDimensions getPanelDimensions(const std::string& modcode, int widthCorrection)
 {
     // Get panel dimensions in VCV Rack millimeter units.
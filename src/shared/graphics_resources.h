@@ -16,14 +16,33 @@
 #define SAPPHIRE_PLUGINS_SHARED_GRAPHICS_RESOURCES_H
 
 #include <cmath>
+#include <memory>
 #include <optional>
 #include <string>
+#include "juce_gui_basics/juce_gui_basics.h"
 #include "sapphire_panel.hpp"
 
 namespace sapphire_plugins::shared
 {
 std::optional<std::string> getSvgForPath(const std::string &path);
 
+/*
+ * The parsed drawable for an svg, shared by every editor in the process. It stays cached
+ * for as long as someone holds it, and the cache pins it while any instance holds a
+ * graphics lease. A drawable which goes into a component tree has to be a createCopy()
+ * of this one, since a component can only have one parent.
+ */
+std::shared_ptr<const juce::Drawable> getSharedDrawable(const std::string &path);
+
+/*
+ * Editors only hold the shared drawables and look and feel while they are open, so on
+ * their own every reopen would parse the svgs again. An instance takes a lease along with
+ * its JUCE shim and drops it before the shim goes, and while any lease is alive everything
+ * handed to pinGraphicsResource stays alive too. Both are main thread only.
+ */
+std::shared_ptr<const void> retainGraphicsResources();
+void pinGraphicsResource(std::shared_ptr<const void> resource);
+
 struct PanelDimensions
 {
     int width;
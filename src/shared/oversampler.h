@@ -0,0 +1,356 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#ifndef SAPPHIRE_PLUGINS_SHARED_OVERSAMPLER_H
+#define SAPPHIRE_PLUGINS_SHARED_OVERSAMPLER_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#include "shared/scratch_arena.h"
+#include "shared/simd_dispatch.h"
+
+namespace sapphire_plugins::shared
+{
+/*
+ * A linear phase half band FIR with 4K-1 taps. Every other tap of a half band filter
+ * is zero apart from the centre tap of 0.5, so in polyphase form one branch is 2K
+ * multiplies and the other is a pure delay. The tables are the non-zero branch, taps
+ * i = 2j of a Blackman-Harris windowed sinc normalized to unity gain at DC,
+ *
+ *   h(i) = sinc(pi (i - (2K - 1)) / 2) * w(i / (4K - 2))
+ *   w(t) = 0.35875 - 0.48829 cos(2 pi t) + 0.14128 cos(4 pi t) - 0.01168 cos(6 pi t)
+ *
+ * worked out once in double precision, so every stage of every instance reads the
+ * same constant table rather than carrying a copy.
+ */
+template <int K> struct HalfBandCoefficients;
+
+template <> struct HalfBandCoefficients<16>
+{
+    static constexpr float values[32]{
+        -6.16084435e-07f, 7.67421534e-06f, -3.9055627e-05f, 0.000126997242f, -0.000332716241f,
+        0.000755810412f, -0.00154429639f, 0.00290509337f, -0.0051175314f, 0.00855927356f,
+        -0.0137704164f, 0.021627048f, -0.0338527299f, 0.0548135638f, -0.100559905f, 0.316421807f,
+        0.316421807f, -0.100559905f, 0.0548135638f, -0.0338527299f, 0.021627048f, -0.0137704164f,
+        0.00855927356f, -0.0051175314f, 0.00290509337f, -0.00154429639f, 0.000755810412f,
+        -0.000332716241f, 0.000126997242f, -3.9055627e-05f, 7.67421534e-06f, -6.16084435e-07f};
+};
+
+template <> struct HalfBandCoefficients<8>
+{
+    static constexpr float values[16]{
+        -1.27324347e-06f, 8.81560045e-05f, -0.00077267806f, 0.00364329759f, -0.0121862227f,
+        0.0331409387f, -0.0842286125f, 0.310316384f, 0.310316384f, -0.0842286125f, 0.0331409387f,
+        -0.0121862227f, 0.00364329759f, -0.00077267806f, 8.81560045e-05f, -1.27324347e-06f};
+};
+
+/*
+ * The filters process in fixed chunks so their working storage is a small inline
+ * array. The FIR runs across the chunk with one coefficient at a time, which keeps it
+ * free of reductions, and goes through the cpu dispatched kernels in simd_dispatch.h.
+ */
+static constexpr int halfBandChunk{64};
+
+template <int K> struct HalfBandUpsampler
+{
+    static constexpr int taps{2 * K};
+    static constexpr int histLen{2 * K - 1};
+
+    void reset() { std::fill(std::begin(work), std::end(work), 0.f); }
+
+    // in is n samples, out is 2n samples
+    void process(const float *in, float *out, uint32_t n)
+    {
+        while (n > 0)
+        {
+            auto m = std::min<uint32_t>(n, halfBandChunk);
+            auto *x = work + histLen;
+            std::copy(in, in + m, x);
+
+            alignas(16) float acc[halfBandChunk]{};
+            simdKernels().firAccumulate(acc, x, HalfBandCoefficients<K>::values, taps, m);
+
+            for (auto i = 0U; i < m; ++i)
+            {
+                out[2 * i] = 2.f * acc[i];
+                out[2 * i + 1] = x[(int)i - (K - 1)];
+            }
+
+            std::memmove(work, work + m, histLen * sizeof(float));
+            in += m;
+            out += 2 * m;
+            n -= m;
+        }
+    }
+
+    alignas(16) float work[histLen + halfBandChunk]{};
+};
+
+template <int K> struct HalfBandDownsampler
+{
+    static constexpr int taps{2 * K};
+    static constexpr int histLen{2 * K - 1};
+
+    void reset()
+    {
+        std::fill(std::begin(evenWork), std::end(evenWork), 0.f);
+        std::fill(std::begin(oddWork), std::end(oddWork), 0.f);
+    }
+
+    // in is 2n samples, out is n samples
+    void process(const float *in, float *out, uint32_t n)
+    {
+        while (n > 0)
+        {
+            auto m = std::min<uint32_t>(n, halfBandChunk);
+            auto *xe = evenWork + histLen;
+            auto *xo = oddWork + K;
+            for (auto i = 0U; i < m; ++i)
+            {
+                xe[i] = in[2 * i];
+                xo[i] = in[2 * i + 1];
+            }
+
+            alignas(16) float acc[halfBandChunk]{};
+            simdKernels().firAccumulate(acc, xe, HalfBandCoefficients<K>::values, taps, m);
+
+            for (auto i = 0U; i < m; ++i)
+                out[i] = acc[i] + 0.5f * oddWork[i];
+
+            std::memmove(evenWork, evenWork + m, histLen * sizeof(float));
+            std::memmove(oddWork, oddWork + m, K * sizeof(float));
+            in += 2 * m;
+            out += m;
+            n -= m;
+        }
+    }
+
+    alignas(16) float evenWork[histLen + halfBandChunk]{};
+    alignas(16) float oddWork[K + halfBandChunk]{};
+};
+
+/*
+ * 2x or 4x oversampling around an engine. The 4x path cascades a second, shorter half
+ * band stage and delays the intermediate 2x signal by one sample so the round trip
+ * latency is a whole number of host samples, which is what we report to the host.
+ *
+ * The same stages also run the other way round, for engines which want a fixed
+ * internal rate below the host's. With a decimation of 2 or 4 the input is filtered
+ * down to the engine rate and the engine output back up, the short stage sitting at
+ * the host rate. Hosts hand us any number of frames, so the decimating path collects
+ * input until it has a whole engine sample, and its output runs decimation - 1 samples
+ * behind so a full block is always ready. That delay is part of the reported latency.
+ */
+template <uint32_t maxChannels> struct Oversampler
+{
+    static constexpr int stage1K{16};
+    static constexpr int stage2K{8};
+
+    uint32_t factor{1};
+    uint32_t decimation{1};
+
+    float *osIn[maxChannels]{};
+    float *osOut[maxChannels]{};
+
+    static size_t bytesNeeded(uint32_t factor, uint32_t decimation, uint32_t maxFrames)
+    {
+        if (decimation > 1)
+        {
+            auto fifoFrames = maxFrames + 2 * decimation;
+            auto res = 2 * maxChannels * ScratchArena::bytesFor<float>(fifoFrames / decimation);
+            res += 2 * maxChannels * ScratchArena::bytesFor<float>(fifoFrames);
+            if (decimation == 4)
+                res += maxChannels * ScratchArena::bytesFor<float>(fifoFrames / 2);
+            return res;
+        }
+        if (factor == 1)
+            return 0;
+        auto res = 2 * maxChannels * ScratchArena::bytesFor<float>(factor * maxFrames);
+        if (factor == 4)
+            res += maxChannels * ScratchArena::bytesFor<float>(2 * maxFrames);
+        return res;
+    }
+
+    void allocate(ScratchArena &arena, uint32_t maxFrames)
+    {
+        assert(factor == 1 || decimation == 1);
+        for (auto c = 0U; c < maxChannels; ++c)
+        {
+            osIn[c] = nullptr;
+            osOut[c] = nullptr;
+            mid[c] = nullptr;
+            pendingIn[c] = nullptr;
+            pendingOut[c] = nullptr;
+            if (decimation > 1)
+            {
+                auto fifoFrames = maxFrames + 2 * decimation;
+                osIn[c] = arena.allocate<float>(fifoFrames / decimation);
+                osOut[c] = arena.allocate<float>(fifoFrames / decimation);
+                pendingIn[c] = arena.allocate<float>(fifoFrames);
+                pendingOut[c] = arena.allocate<float>(fifoFrames);
+                if (decimation == 4)
+                    mid[c] = arena.allocate<float>(fifoFrames / 2);
+                continue;
+            }
+            if (factor == 1)
+                continue;
+            osIn[c] = arena.allocate<float>(factor * maxFrames);
+            osOut[c] = arena.allocate<float>(factor * maxFrames);
+            if (factor == 4)
+                mid[c] = arena.allocate<float>(2 * maxFrames);
+        }
+    }
+
+    uint32_t latency() const
+    {
+        switch (decimation)
+        {
+        case 2:
+            return 2 * (2 * stage1K - 1) + 1;
+        case 4:
+            return 2 * (2 * stage2K - 1) + 4 * (2 * stage1K - 1) + 3;
+        }
+        switch (factor)
+        {
+        case 2:
+            return 2 * stage1K - 1;
+        case 4:
+            return 2 * stage1K - 1 + stage2K;
+        }
+        return 0;
+    }
+
+    void reset()
+    {
+        for (auto c = 0U; c < maxChannels; ++c)
+        {
+            up1[c].reset();
+            up2[c].reset();
+            down1[c].reset();
+            down2[c].reset();
+            midDelay[c] = 0.f;
+            if (pendingOut[c])
+                std::fill(pendingOut[c], pendingOut[c] + decimation - 1, 0.f);
+        }
+        pendingInFrames = 0;
+        pendingOutFrames = decimation - 1;
+    }
+
+    void upsample(float *const *in, uint32_t offset, uint32_t frames, uint32_t chans)
+    {
+        for (auto c = 0U; c < chans; ++c)
+        {
+            if (factor == 2)
+            {
+                up1[c].process(in[c] + offset, osIn[c], frames);
+            }
+            else
+            {
+                up1[c].process(in[c] + offset, mid[c], frames);
+                auto d = midDelay[c];
+                for (auto i = 0U; i < 2 * frames; ++i)
+                    std::swap(d, mid[c][i]);
+                midDelay[c] = d;
+                up2[c].process(mid[c], osIn[c], 2 * frames);
+            }
+        }
+    }
+
+    void downsample(float *const *out, uint32_t offset, uint32_t frames, uint32_t chans)
+    {
+        for (auto c = 0U; c < chans; ++c)
+        {
+            if (factor == 2)
+            {
+                down1[c].process(osOut[c], out[c] + offset, frames);
+            }
+            else
+            {
+                down2[c].process(osOut[c], mid[c], 2 * frames);
+                down1[c].process(mid[c], out[c] + offset, frames);
+            }
+        }
+    }
+
+    /*
+     * Runs frames host samples through an engine at the decimated rate. runEngine is
+     * called with osIn, osOut and the number of engine frames, which may be zero when a
+     * tiny block doesn't complete an engine sample.
+     */
+    template <typename F>
+    void processDecimated(float *const *in, float *const *out, uint32_t offset, uint32_t frames,
+                          uint32_t chans, F &&runEngine)
+    {
+        const auto avail = pendingInFrames + frames;
+        const auto whole = avail - avail % decimation;
+        const auto engineFrames = whole / decimation;
+
+        for (auto c = 0U; c < chans; ++c)
+        {
+            std::copy(in[c] + offset, in[c] + offset + frames, pendingIn[c] + pendingInFrames);
+            if (decimation == 2)
+            {
+                down1[c].process(pendingIn[c], osIn[c], engineFrames);
+            }
+            else
+            {
+                down2[c].process(pendingIn[c], mid[c], 2 * engineFrames);
+                down1[c].process(mid[c], osIn[c], engineFrames);
+            }
+            std::copy(pendingIn[c] + whole, pendingIn[c] + avail, pendingIn[c]);
+        }
+
+        if (engineFrames > 0)
+            runEngine(osIn, osOut, engineFrames);
+
+        assert(pendingOutFrames + whole >= frames);
+        for (auto c = 0U; c < chans; ++c)
+        {
+            auto *fifo = pendingOut[c];
+            if (decimation == 2)
+            {
+                up1[c].process(osOut[c], fifo + pendingOutFrames, engineFrames);
+            }
+            else
+            {
+                up1[c].process(osOut[c], mid[c], engineFrames);
+                up2[c].process(mid[c], fifo + pendingOutFrames, 2 * engineFrames);
+            }
+            std::copy(fifo, fifo + frames, out[c] + offset);
+            std::copy(fifo + frames, fifo + pendingOutFrames + whole, fifo);
+        }
+
+        pendingInFrames = avail - whole;
+        pendingOutFrames = pendingOutFrames + whole - frames;
+    }
+
+  private:
+    HalfBandUpsampler<stage1K> up1[maxChannels];
+    HalfBandUpsampler<stage2K> up2[maxChannels];
+    HalfBandDownsampler<stage1K> down1[maxChannels];
+    HalfBandDownsampler<stage2K> down2[maxChannels];
+    float *mid[maxChannels]{};
+    float midDelay[maxChannels]{};
+
+    float *pendingIn[maxChannels]{};
+    float *pendingOut[maxChannels]{};
+    uint32_t pendingInFrames{0};
+    uint32_t pendingOutFrames{0};
+};
+} // namespace sapphire_plugins::shared
+
+#endif // OVERSAMPLER_H
@@ -0,0 +1,123 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#ifndef SAPPHIRE_PLUGINS_SHARED_PARAM_TABLE_H
+#define SAPPHIRE_PLUGINS_SHARED_PARAM_TABLE_H
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <clap/clap.h>
+#include "sst/basic-blocks/params/ParamMetadata.h"
+
+namespace sapphire_plugins::shared
+{
+struct ParamDesc
+{
+    clap_id id;
+    const char *name;
+    float minVal, maxVal, defaultVal;
+    uint32_t flags;
+
+    constexpr bool stepped() const { return flags & CLAP_PARAM_IS_STEPPED; }
+};
+
+/*
+ * The compile time description of a plugin's params. A param's position in the table is
+ * its dense index, which is also its slot in the patch's params vector, the smoothing
+ * bank and the editor mailbox. Formatting stays with the ParamMetaData each Patch builds
+ * from its entry, since that needs strings and maps which can't be constexpr.
+ */
+template <size_t N> struct ParamTable
+{
+    std::array<ParamDesc, N> descs;
+
+    static constexpr size_t size() { return N; }
+    constexpr const ParamDesc &operator[](size_t i) const { return descs[i]; }
+
+    // Returns size() for an unknown id
+    constexpr size_t indexOf(clap_id id) const
+    {
+        for (size_t i = 0; i < N; ++i)
+            if (descs[i].id == id)
+                return i;
+        return N;
+    }
+
+    constexpr clap_id maxId() const
+    {
+        clap_id res{0};
+        for (const auto &d : descs)
+            res = d.id > res ? d.id : res;
+        return res;
+    }
+};
+
+static constexpr int16_t noParamIndex{-1};
+
+// Maps param id to dense index with a single array read. Ids with no param map to -1.
+template <const auto &table> constexpr auto makeIndexById()
+{
+    std::array<int16_t, table.maxId() + 1> res{};
+    for (auto &r : res)
+        r = noParamIndex;
+    for (size_t i = 0; i < table.size(); ++i)
+        res[table[i].id] = (int16_t)i;
+    return res;
+}
+
+template <const auto &table, clap_id id> sst::basic_blocks::params::ParamMetaData metaFor()
+{
+    constexpr auto idx = table.indexOf(id);
+    static_assert(idx < table.size(), "No param with this id in the table");
+    constexpr auto d = table[idx];
+
+    auto res = sst::basic_blocks::params::ParamMetaData();
+    res = d.stepped() ? res.asInt() : res.asFloat();
+    return res.withFlags(d.flags)
+        .withName(d.name)
+        .withID(d.id)
+        .withRange(d.minVal, d.maxVal)
+        .withDefault(d.defaultVal);
+}
+
+// The patch must push its params in table order for the dense indices to hold
+template <typename Params, size_t N>
+bool paramsMatchTable(const Params &params, const ParamTable<N> &table)
+{
+    if (params.size() != N)
+        return false;
+    for (size_t i = 0; i < N; ++i)
+        if (params[i]->meta.id != table[i].id)
+            return false;
+    return true;
+}
+
+inline void fillParamInfo(const ParamDesc &d, void *cookie, clap_param_info_t *info)
+{
+    info->id = d.id;
+    info->flags = d.flags;
+    info->cookie = cookie;
+    strncpy(info->name, d.name, CLAP_NAME_SIZE);
+    info->name[CLAP_NAME_SIZE - 1] = 0;
+    info->module[0] = 0;
+    info->min_value = d.minVal;
+    info->max_value = d.maxVal;
+    info->default_value = d.defaultVal;
+}
+} // namespace sapphire_plugins::shared
+
+#endif // PARAM_TABLE_H
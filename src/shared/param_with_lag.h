@@ -17,7 +17,7 @@
 
 #include "sst/plugininfra/patch-support/patch_base.h"
 #include "sst/basic-blocks/params/ParamMetadata.h"
-#include "sst/basic-blocks/dsp/Lag.h"
+#include "shared/smoothing_bank.h"
 
 namespace sapphire_plugins::shared
 {
@@ -34,8 +34,35 @@ struct ParamWithLag : sst::plugininfra::patch_support::ParamBase
         return *this;
     }
 
-    sst::basic_blocks::dsp::OnePoleLag<float, true> lag;
-    void snap() { lag.snapTo(value); }
+    /*
+     * The smoothed value lives in the owning processor's SmoothingBank. Params which
+     * are not bound to a bank (like the editor's patch copy) just read back value.
+     */
+    SmoothingBank *bank{nullptr};
+    uint32_t bankIndex{0};
+
+    void bindTo(SmoothingBank &b)
+    {
+        bank = &b;
+        bankIndex = b.add(value);
+    }
+    void setTarget(float v)
+    {
+        if (!bank)
+            return;
+        // Stepped params jump straight to their new value rather than gliding through
+        // the intermediate steps
+        if (meta.type == sst::basic_blocks::params::ParamMetaData::FLOAT)
+            bank->setTarget(bankIndex, v);
+        else
+            bank->snapTo(bankIndex, v);
+    }
+    void snap()
+    {
+        if (bank)
+            bank->snapTo(bankIndex, value);
+    }
+    float smoothed() const { return bank ? bank->current[bankIndex] : value; }
 };
 } // namespace sapphire_plugins::shared
 #endif // PARAM_WITH_LAG_H
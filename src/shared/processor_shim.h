@@ -17,7 +17,6 @@
 
 #include "sst/plugininfra/version_information.h"
 #include "sst/plugininfra/patch-support/patch_base_clap_adapter.h"
-#include "sst/cpputils/ring_buffer.h"
 
 #include "configuration.h"
 #include <clap/clap.h>
@@ -27,8 +26,25 @@
 #include <clap/helpers/host-proxy.hxx>
 #include <clapwrapper/vst3.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <limits>
 #include <memory>
+#include <tuple>
+#include <utility>
+#include <type_traits>
 #include "shared/editor_interactions.h"
+#include "shared/param_with_lag.h"
+#include "shared/param_table.h"
+#include "shared/binary_state.h"
+#include "shared/triple_buffer.h"
+#include "shared/smoothing_bank.h"
+#include "shared/scratch_arena.h"
+#include "shared/allocation_tally.h"
+#include "shared/oversampler.h"
+#include "shared/graphics_resources.h"
 #include "sst/clap_juce_shim/clap_juce_shim.h"
 
 namespace sapphire_plugins::shared
@@ -40,41 +56,91 @@ static constexpr clap::helpers::CheckingLevel checkLevel = clap::helpers::Checki
 
 using plugHelper_t = clap::helpers::Plugin<misLevel, checkLevel>;
 
-template <typename Processor>
+/*
+ * How smoothed values reach the engine. Stepped hands the engine one new value per
+ * smoothing block. SampleAccurate interpolates linearly across the block and calls the
+ * setters of moving params every sample, which costs more while automating but removes
+ * the zipper noise on fast sweeps of sensitive params like filter frequency.
+ */
+struct SteppedSmoothing
+{
+    static constexpr bool sampleAccurate{false};
+};
+struct SampleAccurateSmoothing
+{
+    static constexpr bool sampleAccurate{true};
+};
+
+/*
+ * maxChannels above 2 adds the audio ports config extension, offering stereo, quad, 5.1
+ * and 7.1 main ports up to that count, and the surround extension to describe the wider
+ * layouts. The processor's engine has to handle every channel itself.
+ */
+template <typename Processor, typename SmoothingPolicy = SteppedSmoothing,
+          uint32_t maxChannels = 2>
 struct ProcessorShim : plugHelper_t, sst::clap_juce_shim::EditorProvider
 {
-    static constexpr size_t smoothingBlock{8};
+    /*
+     * Realtime playback steps params every few samples. An offline render smooths every
+     * sample and runs the oversampled engines at their highest factor, since nobody is
+     * waiting on it. Both are picked up on activate. The higher factor changes our
+     * latency for the bounce, and activate reports that through latencyChanged so the
+     * host compensates the render just as it does playback.
+     */
+    static constexpr uint32_t realtimeSmoothingBlock{8};
+    static constexpr uint32_t offlineSmoothingBlock{1};
+    static constexpr uint32_t offlineOversampling{4};
+    /*
+     * Engines with supportsFixedEngineRate can ask to run at the host rate divided by the
+     * power of two which lands at or above this, so 48k and 96k sessions both run the
+     * engine at 48k and cost the same. Oversampling then multiplies that fixed rate.
+     */
+    static constexpr double fixedEngineRateFloor{44100};
+    static constexpr uint32_t maxEngineDecimation{4};
     static constexpr double smoothingMilis{5};
+    static constexpr uint32_t maxPortChannels{maxChannels};
+    static_assert(maxPortChannels >= 2 && maxPortChannels <= 8 && maxPortChannels % 2 == 0);
 
     ProcessorShim(const clap_plugin_descriptor_t *desc, const clap_host_t *host)
         : plugHelper_t(desc, host)
     {
-        clapJuceShim = std::make_unique<sst::clap_juce_shim::ClapJuceShim>(this);
-        clapJuceShim->setResizable(false);
     }
 
     Processor *asProcessor() { return static_cast<Processor *>(this); }
     const Processor *asProcessor() const { return static_cast<const Processor *>(this); }
 
+    // Runs on the audio thread when an editor attaches or a loaded state is adopted, so
+    // it must not log or allocate
     void pushFullUIRefresh()
     {
-        SPLLOG("Full UI Refresh Requested");
-
-        for (const auto *p : asProcessor()->patch.params)
-        {
-            shared::AudioToUIMsg au{shared::AudioToUIMsg::UPDATE_PARAM, p->meta.id, p->value};
-            audioToUi.push(au);
-        }
+        const auto &params = asProcessor()->patch.params;
+        for (auto i = 0U; i < params.size(); ++i)
+            paramMailbox.post(i, params[i]->value);
     }
 
-    shared::audioToUIQueue_t audioToUi;
-    shared::uiToAudioQueue_T uiToAudio;
+    /*
+     * The mailbox is the only state the main thread touches at idle rate, when the
+     * editor drains it, so it sits on its own cache lines. The block which follows is
+     * what the audio thread reads on every process call, and it starts on a fresh line
+     * so the editor's drain never invalidates it. The main thread still writes some later
+     * members, like the editor queue owner, the state buffers and the JUCE shim, but only
+     * on rare events such as opening an editor or loading a preset.
+     */
+    shared::ParamMailbox paramMailbox;
+
+    alignas(shared::cacheLineSize) double sampleRate{0};
+    // The rate the engine actually runs at, which differs from sampleRate when oversampling
+    double engineSampleRate{0};
+    uint32_t portChannels{2};
+    uint32_t smoothingBlock{realtimeSmoothingBlock};
+    clap_plugin_render_mode renderMode{CLAP_RENDER_REALTIME};
+    // Set and read only by the audio thread, from the editor's attach and detach messages
     bool isEditorAttached{false};
-    double sampleRate{0};
 
     uint32_t nextEventIndex{0};
     const clap_event_header_t *nextEvent{nullptr};
     uint32_t eventQSize{0};
+    size_t blockPos{0};
 
     void startProcessEventTraversal(const clap_input_events_t *ev)
     {
@@ -100,31 +166,622 @@ struct ProcessorShim : plugHelper_t, sst::clap_juce_shim::EditorProvider
         }
     }
 
-    bool init() noexcept override { return true; }
+    /*
+     * The host buffer is cut into sub-blocks which end at either the next smoothing
+     * block edge or the next event, whichever comes first. Parameters are smoothed and
+     * pushed to the engine at each smoothing edge and the processor gets a contiguous
+     * run of samples to hand to its engine in one call. The edges sit on a fixed grid
+     * which runs on across host buffers, so the smoothing time doesn't depend on the
+     * host's buffer size.
+     *
+     * If the input is silent, nothing is moving and the output has been quiet for a short
+     * window we skip the engine entirely and let the host sleep us. A processor whose
+     * tail is currently endless never sleeps.
+     *
+     * 64 bit ports are converted to and from float scratch buffers on the way in and out,
+     * since the engines all run in single precision.
+     */
+    clap_process_status process(const clap_process *process) noexcept override
+    {
+        auto ev = process->in_events;
+        auto outq = process->out_events;
+
+        const auto &inBuf = process->audio_inputs[0];
+        auto &outBuf = process->audio_outputs[0];
+        const uint32_t frames = process->frames_count;
+        const auto inChans = std::min(inBuf.channel_count, portChannels);
+        const auto outChans = std::min(outBuf.channel_count, portChannels);
+
+        float **in = inBuf.data32;
+        float **out = outBuf.data32;
+        if (inBuf.data64)
+        {
+            for (auto c = 0U; c < inChans; ++c)
+                convertBuffer(inBuf.data64[c], in64Scratch[c], frames);
+            in = in64Scratch;
+        }
+        if (outBuf.data64)
+        {
+            out = out64Scratch;
+        }
+
+        adoptLoadedState();
+        shared::processUIQueueFromAudio(asProcessor(), outq);
+
+        startProcessEventTraversal(ev);
+
+        const auto inputSilent = bufferIsSilent(in, inChans, frames);
+        if (inputSilent && eventQSize == 0 && smoothing.isSettled() && canSleep())
+        {
+            if constexpr (SmoothingPolicy::sampleAccurate)
+                finishRamps();
+            for (auto c = 0U; c < outChans; ++c)
+            {
+                if (outBuf.data64)
+                    std::fill(outBuf.data64[c], outBuf.data64[c] + frames, 0.0);
+                else
+                    std::fill(out[c], out[c] + frames, 0.f);
+            }
+            outBuf.constant_mask = ((uint64_t)1 << outChans) - 1;
+            return CLAP_PROCESS_SLEEP;
+        }
+
+        uint32_t s{0};
+        while (s < frames)
+        {
+            processEventsUpTo(s, ev);
+
+            if (blockPos == 0)
+            {
+                if constexpr (SmoothingPolicy::sampleAccurate)
+                {
+                    startRamps();
+                }
+                else
+                {
+                    smoothing.process();
+                    pushChangedParamsToEngine();
+                }
+            }
+
+            uint32_t end = std::min<uint32_t>(frames, s + (smoothingBlock - blockPos));
+            if (nextEvent && nextEvent->time > s && nextEvent->time < end)
+                end = nextEvent->time;
+
+            auto n = end - s;
+            if constexpr (SmoothingPolicy::sampleAccurate)
+            {
+                if (ramps.mask)
+                    runRampedBlock(in, out, s, n, inChans);
+                else
+                    runEngineBlock(in, out, s, n, inChans);
+            }
+            else
+            {
+                runEngineBlock(in, out, s, n, inChans);
+            }
+            blockPos = (blockPos + n) & (smoothingBlock - 1);
+            s = end;
+        }
+
+        processEventsUpTo(frames, ev);
+
+        if (inputSilent && bufferIsSilent(out, outChans, frames))
+            quietOutputSamples += frames;
+        else
+            quietOutputSamples = 0;
+
+        outBuf.constant_mask = 0;
+        checkTailChanged();
+
+        if (outBuf.data64)
+        {
+            for (auto c = 0U; c < outChans; ++c)
+                convertBuffer(out64Scratch[c], outBuf.data64[c], frames);
+        }
+
+        return CLAP_PROCESS_CONTINUE;
+    }
+
+    /*
+     * Ramp state for the sample accurate policy. At each smoothing edge every moving
+     * param gets a linear ramp from where it was to where the lag lands at the end of
+     * the block, and those params are excluded from the stepped dispatch. blockPos runs
+     * on across host buffers, so a ramp cut off by the end of one buffer carries on
+     * from the same position in the next. The stepped policy has no ramps and carries
+     * no storage for them.
+     */
+    struct RampStorage
+    {
+        uint64_t mask{0};
+        alignas(16) float values[SmoothingBank::maxParams][realtimeSmoothingBlock]{};
+    };
+    struct NoRampStorage
+    {
+    };
+    std::conditional_t<SmoothingPolicy::sampleAccurate, RampStorage, NoRampStorage> ramps;
+
+    void startRamps()
+    {
+        auto moving = smoothing.active;
+        alignas(16) float start[SmoothingBank::maxParams];
+        auto m = moving;
+        while (m)
+        {
+            auto idx = lowestSetBit(m);
+            m &= m - 1;
+            start[idx] = smoothing.current[idx];
+        }
+
+        smoothing.process();
+        smoothing.changed &= ~moving;
+        pushChangedParamsToEngine();
+
+        ramps.mask = moving;
+        const float dt = 1.f / smoothingBlock;
+        m = moving;
+        while (m)
+        {
+            auto idx = lowestSetBit(m);
+            m &= m - 1;
+            const auto v0 = start[idx];
+            const auto dv = (smoothing.current[idx] - v0) * dt;
+            for (auto k = 0U; k < smoothingBlock; ++k)
+                ramps.values[idx][k] = v0 + dv * (k + 1);
+        }
+    }
+
+    void runRampedBlock(float **in, float **out, uint32_t offset, uint32_t frames,
+                        uint32_t chans)
+    {
+        for (auto i = 0U; i < frames; ++i)
+        {
+            const auto pos = blockPos + i;
+            auto m = ramps.mask;
+            while (m)
+            {
+                auto idx = lowestSetBit(m);
+                m &= m - 1;
+                if (engineSetters[idx])
+                    engineSetters[idx](*asProcessor(), ramps.values[idx][pos]);
+            }
+            runEngineBlock(in, out, offset + i, 1, chans);
+        }
+    }
+
+    // We are about to sleep partway through a ramp, so land the engine where the lags
+    // already are and start a fresh block when we wake
+    void finishRamps()
+    {
+        auto m = ramps.mask;
+        while (m)
+        {
+            auto idx = lowestSetBit(m);
+            m &= m - 1;
+            if (engineSetters[idx])
+                engineSetters[idx](*asProcessor(), smoothing.current[idx]);
+        }
+        ramps.mask = 0;
+        blockPos = 0;
+    }
+
+    void runEngineBlock(float **in, float **out, uint32_t offset, uint32_t frames,
+                        uint32_t chans)
+    {
+        if constexpr (Processor::supportsFixedEngineRate)
+        {
+            if (engineDecimation > 1)
+            {
+                oversampler->processDecimated(
+                    in, out, offset, frames, chans, [this, chans](auto *ein, auto *eout, auto n)
+                    { asProcessor()->processEngineBlock(ein, eout, 0, n, chans); });
+                return;
+            }
+        }
+        if constexpr (Processor::supportsOversampling)
+        {
+            if (engineOversampling > 1)
+            {
+                oversampler->upsample(in, offset, frames, chans);
+                asProcessor()->processEngineBlock(oversampler->osIn, oversampler->osOut, 0,
+                                                  frames * engineOversampling, chans);
+                oversampler->downsample(out, offset, frames, chans);
+                return;
+            }
+        }
+        asProcessor()->processEngineBlock(in, out, offset, frames, chans);
+    }
+
+    /*
+     * Oversampling and the fixed engine rate are chosen by stepped params on the
+     * processor but only take effect on activate, since they change our latency. When
+     * either param moves away from the running rate we ask the host to restart us.
+     *
+     * Only processors which can change their engine rate get an oversampler, built on
+     * their first activate, since its filter state is sized for every port channel.
+     */
+    using oversampler_t = Oversampler<maxPortChannels>;
+    std::unique_ptr<oversampler_t> oversampler;
+    uint32_t engineOversampling{1};
+    uint32_t engineDecimation{1};
+
+    static constexpr bool changesEngineRate()
+    {
+        return Processor::supportsOversampling || Processor::supportsFixedEngineRate;
+    }
+
+    uint32_t engineLatency() const { return oversampler ? oversampler->latency() : 0; }
+
+    uint32_t targetOversampling() const
+    {
+        if constexpr (Processor::supportsOversampling)
+        {
+            if (renderMode == CLAP_RENDER_OFFLINE)
+                return offlineOversampling;
+            return asProcessor()->requestedOversampling();
+        }
+        else
+        {
+            return 1;
+        }
+    }
+
+    uint32_t targetDecimation() const
+    {
+        if constexpr (Processor::supportsFixedEngineRate)
+        {
+            if (!asProcessor()->requestedFixedEngineRate())
+                return 1;
+            uint32_t res{1};
+            while (res < maxEngineDecimation && sampleRate / (2 * res) >= fixedEngineRateFloor)
+                res *= 2;
+            return res;
+        }
+        else
+        {
+            return 1;
+        }
+    }
+
+    // Oversampling a decimated engine just cancels stages, so at most one of these is > 1
+    std::pair<uint32_t, uint32_t> targetEngineRate() const
+    {
+        auto up = targetOversampling();
+        auto down = targetDecimation();
+        while (up > 1 && down > 1)
+        {
+            up /= 2;
+            down /= 2;
+        }
+        return {up, down};
+    }
+
+    uint32_t targetSmoothingBlock() const
+    {
+        return renderMode == CLAP_RENDER_OFFLINE ? offlineSmoothingBlock : realtimeSmoothingBlock;
+    }
+
+    bool engineRateChanged() const
+    {
+        return targetEngineRate() != std::make_pair(engineOversampling, engineDecimation);
+    }
+
+    void engineRateParamChanged()
+    {
+        if (isActive() && engineRateChanged())
+            _host.requestRestart();
+    }
+
+    bool implementsRender() const noexcept override { return true; }
+    bool renderHasHardRealtimeRequirement() noexcept override { return false; }
+    bool renderSet(clap_plugin_render_mode mode) noexcept override
+    {
+        renderMode = mode;
+        auto changesEngine = engineRateChanged() || targetSmoothingBlock() != smoothingBlock;
+        if (isActive() && changesEngine)
+            _host.requestRestart();
+        return true;
+    }
+
+    bool implementsLatency() const noexcept override { return changesEngineRate(); }
+    uint32_t latencyGet() const noexcept override { return engineLatency(); }
+
+    // CLAP wants latencyChanged from inside activate whenever the rate we picked moves it
+    uint32_t reportedLatency{0};
+    void notifyLatencyIfChanged()
+    {
+        auto latency = engineLatency();
+        if (latency == reportedLatency)
+            return;
+        reportedLatency = latency;
+        if (_host.canUseLatency())
+            _host.latencyChanged();
+    }
+
+    float *in64Scratch[maxPortChannels]{};
+    float *out64Scratch[maxPortChannels]{};
+
+    template <typename S, typename D>
+    static void convertBuffer(const S *__restrict src, D *__restrict dst, uint32_t frames)
+    {
+        for (auto s = 0U; s < frames; ++s)
+            dst[s] = (D)src[s];
+    }
+
+    static constexpr float silenceThreshold{1e-5f};
+    uint64_t quietOutputSamples{0};
+
+    /*
+     * The reported tail is what a host should render after the input stops, which for
+     * a long reverb is far longer than we need to wait before sleeping. Once the output
+     * has stayed below the silence threshold for this window with silent input and
+     * settled params, there is nothing left in the engine we could hear.
+     */
+    static constexpr double sleepQuietSeconds{0.25};
+    uint64_t sleepQuietSamples{0};
+
+    bool canSleep() const
+    {
+        auto tail = asProcessor()->tailSamples();
+        if (tail == std::numeric_limits<uint32_t>::max())
+            return false;
+        return quietOutputSamples >= std::min<uint64_t>(tail, sleepQuietSamples);
+    }
+
+    static bool bufferIsSilent(float *const *data, uint32_t channels, uint32_t frames)
+    {
+        for (auto c = 0U; c < channels; ++c)
+        {
+            float peak{0.f};
+            for (auto s = 0U; s < frames; ++s)
+                peak = std::max(peak, std::fabs(data[c][s]));
+            if (peak > silenceThreshold)
+                return false;
+        }
+        return true;
+    }
+
+    // Processors can override this if their tail depends on the patch. Return the max
+    // uint32_t for an endless tail.
+    uint32_t tailSamples() const { return (uint32_t)(sampleRate * Processor::tailSeconds); }
+
+    bool implementsTail() const noexcept override { return true; }
+    uint32_t tailGet() const noexcept override { return asProcessor()->tailSamples(); }
+
+    // Hosts cache what tailGet returned, so tell them when a param moves it
+    uint32_t reportedTailSamples{0};
+    void checkTailChanged()
+    {
+        auto tail = asProcessor()->tailSamples();
+        if (tail == reportedTailSamples)
+            return;
+        reportedTailSamples = tail;
+        if (_host.canUseTail())
+            _host.tailChanged();
+    }
+
+    SmoothingBank smoothing;
+
+    /*
+     * Each param is bound once to the engine setter which consumes it. After smoothing
+     * only the setters for params whose smoothed value moved get called, so a static
+     * patch never touches the engine (or recomputes derived values like the pow calls
+     * in tube unit) at all.
+     */
+    using engineSetter_t = void (*)(Processor &, float);
+    engineSetter_t engineSetters[SmoothingBank::maxParams]{};
+
+    void bindParamToEngine(const typename Processor::param_t &p, engineSetter_t f)
+    {
+        assert(p.bank == &smoothing);
+        engineSetters[p.bankIndex] = f;
+    }
+
+    void pushChangedParamsToEngine()
+    {
+        auto m = smoothing.changed;
+        smoothing.changed = 0;
+        while (m)
+        {
+            auto idx = lowestSetBit(m);
+            m &= m - 1;
+            if (engineSetters[idx])
+                engineSetters[idx](*asProcessor(), smoothing.current[idx]);
+        }
+    }
+
+    bool init() noexcept override
+    {
+        static_assert(std::is_same_v<typename Processor::param_t, ParamWithLag>,
+                      "Param cookies assume ParamWithLag");
+        static_assert(Processor::patch_t::paramTable.size() <= SmoothingBank::maxParams);
+
+        // Binding in table order makes each param's bank index its dense index
+        for (auto *p : asProcessor()->patch.params)
+            p->bindTo(smoothing);
+        asProcessor()->bindEngineSetters();
+        return true;
+    }
+
+    /*
+     * Events resolve their param from the cookie we hand out in paramsInfo. Events which
+     * come without one (and messages from our own editor) fall back to the compile time
+     * id to dense index table.
+     */
+    ParamWithLag *paramFromId(clap_id id) const
+    {
+        static constexpr auto indexById = makeIndexById<Processor::patch_t::paramTable>();
+        if (id >= indexById.size() || indexById[id] == noParamIndex)
+            return nullptr;
+        return asProcessor()->patch.params[indexById[id]];
+    }
+
+    /*
+     * Engines are built here rather than in the constructor, since hosts create plenty of
+     * instances which are only scanned or never activated, and they are freed again in
+     * deactivate. The engine setters see every param on the first block after this, so a
+     * fresh engine picks up the current patch.
+     */
     bool activate(double sampleRate, uint32_t minFrameCount,
                   uint32_t maxFrameCount) noexcept override
     {
         this->sampleRate = sampleRate;
-        for (auto &[id, p] : asProcessor()->patch.paramMap)
-            p->lag.setRateInMilliseconds(smoothingMilis, sampleRate, smoothingBlock);
+        std::tie(engineOversampling, engineDecimation) = targetEngineRate();
+        engineSampleRate = sampleRate * engineOversampling / engineDecimation;
+        if constexpr (changesEngineRate())
+        {
+            if (!oversampler)
+                oversampler = std::make_unique<oversampler_t>();
+            oversampler->factor = engineOversampling;
+            oversampler->decimation = engineDecimation;
+        }
+        notifyLatencyIfChanged();
+        AllocationTally engineHeap;
+        asProcessor()->createEngine();
+        engineHeap.stop();
+        smoothingBlock = targetSmoothingBlock();
+        assert(smoothingBlock <= realtimeSmoothingBlock);
+        blockPos = 0;
+        if constexpr (SmoothingPolicy::sampleAccurate)
+            ramps.mask = 0;
+        smoothing.setRateInMilliseconds(smoothingMilis, sampleRate, smoothingBlock);
+        smoothing.markAllChanged();
+        quietOutputSamples = 0;
+        sleepQuietSamples = (uint64_t)(sampleRate * sleepQuietSeconds);
+        reportedTailSamples = asProcessor()->tailSamples();
+
+        scratch.unlock();
+        scratch.reserve(scratchBytesNeeded(maxFrameCount));
+        for (auto c = 0U; c < maxPortChannels; ++c)
+        {
+            in64Scratch[c] = scratch.allocate<float>(maxFrameCount);
+            out64Scratch[c] = scratch.allocate<float>(maxFrameCount);
+        }
+        if (oversampler)
+        {
+            oversampler->allocate(scratch, maxFrameCount);
+            oversampler->reset();
+        }
+        scratch.lock();
+#if SAPPHIRE_MEMORY_REPORT
+        SPLLOG("Memory footprint" << SPLV(sampleRate) << SPLV(engineSampleRate)
+                                  << SPLV(engineOversampling) << SPLV(engineDecimation)
+                                  << SPLV(portChannels) << SPLV(sizeof(Processor))
+                                  << SPLV(engineHeap.bytes) << SPLV(scratch.capacity));
+#endif
         return true;
     }
-    void deactivate() noexcept override {}
+    void deactivate() noexcept override
+    {
+        asProcessor()->releaseEngine();
+        scratch.unlock();
+    }
+
+    /*
+     * Every buffer the audio thread uses comes out of this arena, which is sized and
+     * carved up in activate(). Anything which needs per-block storage should add its
+     * footprint to scratchBytesNeeded and allocate it alongside the conversion buffers.
+     */
+    ScratchArena scratch;
+
+    size_t scratchBytesNeeded(uint32_t maxFrameCount) const
+    {
+        return 2 * maxPortChannels * ScratchArena::bytesFor<float>(maxFrameCount) +
+               oversampler_t::bytesNeeded(engineOversampling, engineDecimation, maxFrameCount);
+    }
 
-    bool implementsGui() const noexcept override { return clapJuceShim != nullptr; }
+    // The JUCE shim is only built the first time the host asks about the gui
+    bool implementsGui() const noexcept override { return true; }
     std::unique_ptr<sst::clap_juce_shim::ClapJuceShim> clapJuceShim;
-    ADD_SHIM_IMPLEMENTATION(clapJuceShim)
-    ADD_SHIM_LINUX_TIMER(clapJuceShim)
+    // Declared after the shim so the pinned graphics are released while JUCE is still up
+    std::shared_ptr<const void> graphicsLease;
+    sst::clap_juce_shim::ClapJuceShim *juceShim()
+    {
+        if (!clapJuceShim)
+        {
+            clapJuceShim = std::make_unique<sst::clap_juce_shim::ClapJuceShim>(this);
+            clapJuceShim->setResizable(false);
+            graphicsLease = shared::retainGraphicsResources();
+        }
+        return clapJuceShim.get();
+    }
+    ADD_SHIM_IMPLEMENTATION(juceShim())
+    ADD_SHIM_LINUX_TIMER(juceShim())
     std::unique_ptr<juce::Component> createEditor() override
     {
+        using queues_t = typename Processor::editor_t::editorQueues_t;
+
+        if (!editorQueues)
+        {
+            editorQueues = std::make_unique<queues_t>();
+            editorQueues->requestRelease = [this]() { _host.requestCallback(); };
+            SPLLOG("Editor queues allocated: " << sizeof(queues_t) << " bytes; instance is "
+                                               << sizeof(Processor) << " bytes");
+        }
+        liveEditorQueues.store(editorQueues.get(), std::memory_order_seq_cst);
+
         pushFullUIRefresh();
         auto res = std::make_unique<typename Processor::editor_t>(
-            audioToUi, uiToAudio, [this]() { _host.paramsRequestFlush(); });
+            *static_cast<queues_t *>(editorQueues.get()), paramMailbox,
+            [this]() { _host.paramsRequestFlush(); });
         // res->clapHost = _host.host();
 
         return res;
     }
 
+    /*
+     * The queues are owned on the main thread and published to the audio thread through
+     * liveEditorQueues. The audio thread raises audioInEditorQueues around its use, so
+     * once the editor is gone the main thread can unpublish them and free them as soon
+     * as it sees the audio thread is not inside. All of these are seq_cst so that check
+     * can't pass while the audio thread holds a pointer it loaded before the unpublish.
+     */
+    std::unique_ptr<shared::EditorQueuesBase> editorQueues;
+    alignas(shared::cacheLineSize) std::atomic<shared::EditorQueuesBase *> liveEditorQueues{
+        nullptr};
+    std::atomic<bool> audioInEditorQueues{false};
+
+    auto *acquireEditorQueues()
+    {
+        using queues_t = typename Processor::editor_t::editorQueues_t;
+
+        // With no editor open, which is nearly always, skip the handshake. Nothing is
+        // dereferenced on this path, so a plain acquire load is enough.
+        if (liveEditorQueues.load(std::memory_order_acquire) == nullptr)
+            return static_cast<queues_t *>(nullptr);
+
+        audioInEditorQueues.store(true, std::memory_order_seq_cst);
+        auto *q = liveEditorQueues.load(std::memory_order_seq_cst);
+        if (!q)
+            audioInEditorQueues.store(false, std::memory_order_seq_cst);
+        return static_cast<queues_t *>(q);
+    }
+
+    void releaseEditorQueues() { audioInEditorQueues.store(false, std::memory_order_seq_cst); }
+
+    // Called on the audio thread once it has seen the editor detach. detachEditor asks
+    // for the same callback from the main thread, so either one gets the queues freed.
+    void requestEditorQueueRelease() { _host.requestCallback(); }
+
+    void onMainThread() noexcept override
+    {
+        if (loadedStateAdopted.exchange(false, std::memory_order_acquire))
+            _host.paramsRescan(CLAP_PARAM_RESCAN_VALUES);
+
+        if (!editorQueues || editorQueues->editorAlive)
+            return;
+
+        liveEditorQueues.store(nullptr, std::memory_order_seq_cst);
+        if (audioInEditorQueues.load(std::memory_order_seq_cst))
+        {
+            _host.requestCallback();
+            return;
+        }
+
+        editorQueues.reset();
+        SPLLOG("Editor queues released; instance is " << sizeof(Processor) << " bytes");
+    }
+
     bool registerOrUnregisterTimer(clap_id &id, int ms, bool reg) override
     {
         if (!_host.canUseTimerSupport())
@@ -141,11 +798,17 @@ struct ProcessorShim : plugHelper_t, sst::clap_juce_shim::EditorProvider
     }
 
     bool implementsParams() const noexcept override { return true; }
-    uint32_t paramsCount() const noexcept override { return asProcessor()->patch.params.size(); }
+    uint32_t paramsCount() const noexcept override
+    {
+        return Processor::patch_t::paramTable.size();
+    }
     bool paramsInfo(uint32_t paramIndex, clap_param_info *info) const noexcept override
     {
-        return sst::plugininfra::patch_support::patchParamsInfo(paramIndex, info,
-                                                                asProcessor()->patch);
+        if (paramIndex >= Processor::patch_t::paramTable.size())
+            return false;
+        fillParamInfo(Processor::patch_t::paramTable[paramIndex],
+                      asProcessor()->patch.params[paramIndex], info);
+        return true;
     }
     bool paramsValue(clap_id paramId, double *value) noexcept override
     {
@@ -175,6 +838,7 @@ struct ProcessorShim : plugHelper_t, sst::clap_juce_shim::EditorProvider
             handleEvent(nextEvent);
         }
 
+        adoptLoadedState();
         shared::processUIQueueFromAudio(asProcessor(), out);
     }
 
@@ -208,34 +872,190 @@ struct ProcessorShim : plugHelper_t, sst::clap_juce_shim::EditorProvider
             strncpy(info->name, "Main Input", sizeof(info->name));
         else
             strncpy(info->name, "Main Out", sizeof(info->name));
-        info->flags = CLAP_AUDIO_PORT_IS_MAIN;
-        info->channel_count = 2;
-        info->port_type = CLAP_PORT_STEREO;
+        info->flags = CLAP_AUDIO_PORT_IS_MAIN | CLAP_AUDIO_PORT_SUPPORTS_64BITS;
+        info->channel_count = portChannels;
+        info->port_type = portTypeFor(portChannels);
+        return true;
+    }
+
+    static const char *portTypeFor(uint32_t chans)
+    {
+        return chans == 2 ? CLAP_PORT_STEREO : CLAP_PORT_SURROUND;
+    }
+
+    // Config ids are just the channel count
+    bool implementsAudioPortsConfig() const noexcept override { return maxPortChannels > 2; }
+    uint32_t audioPortsConfigCount() const noexcept override { return maxPortChannels / 2; }
+    bool audioPortsConfigGet(uint32_t index,
+                             clap_audio_ports_config *config) const noexcept override
+    {
+        if (index >= audioPortsConfigCount())
+            return false;
+
+        static constexpr const char *names[] = {"Stereo", "Quad", "5.1", "7.1"};
+        auto chans = 2 * (index + 1);
+        config->id = chans;
+        strncpy(config->name, names[index], sizeof(config->name));
+        config->input_port_count = Processor::hasStereoInput ? 1 : 0;
+        config->output_port_count = Processor::hasStereoOutput ? 1 : 0;
+        config->has_main_input = Processor::hasStereoInput;
+        config->main_input_channel_count = chans;
+        config->main_input_port_type = portTypeFor(chans);
+        config->has_main_output = Processor::hasStereoOutput;
+        config->main_output_channel_count = chans;
+        config->main_output_port_type = portTypeFor(chans);
+        return true;
+    }
+    bool audioPortsConfigSelect(clap_id configId) noexcept override
+    {
+        if (configId < 2 || configId > maxPortChannels || configId % 2 != 0 || isActive())
+            return false;
+        portChannels = configId;
         return true;
     }
 
+    /*
+     * Quad and wider are surround ports, which a host can only route once the surround
+     * extension tells it which speaker each channel is. These follow the usual WAVE
+     * channel orders.
+     */
+    static const uint8_t *surroundMapFor(uint32_t chans)
+    {
+        static constexpr uint8_t quad[]{CLAP_SURROUND_FL, CLAP_SURROUND_FR, CLAP_SURROUND_BL,
+                                        CLAP_SURROUND_BR};
+        static constexpr uint8_t fiveOne[]{CLAP_SURROUND_FL, CLAP_SURROUND_FR, CLAP_SURROUND_FC,
+                                           CLAP_SURROUND_LFE, CLAP_SURROUND_BL, CLAP_SURROUND_BR};
+        static constexpr uint8_t sevenOne[]{CLAP_SURROUND_FL, CLAP_SURROUND_FR, CLAP_SURROUND_FC,
+                                            CLAP_SURROUND_LFE, CLAP_SURROUND_BL, CLAP_SURROUND_BR,
+                                            CLAP_SURROUND_SL, CLAP_SURROUND_SR};
+        switch (chans)
+        {
+        case 4:
+            return quad;
+        case 6:
+            return fiveOne;
+        case 8:
+            return sevenOne;
+        }
+        return nullptr;
+    }
+
+    bool implementsSurround() const noexcept override { return maxPortChannels > 2; }
+    bool surroundIsChannelMaskSupported(uint64_t channelMask) const noexcept override
+    {
+        for (auto chans = 4U; chans <= maxPortChannels; chans += 2)
+        {
+            uint64_t mask{0};
+            const auto *map = surroundMapFor(chans);
+            for (auto c = 0U; c < chans; ++c)
+                mask |= (uint64_t)1 << map[c];
+            if (mask == channelMask)
+                return true;
+        }
+        return false;
+    }
+    uint32_t surroundGetChannelMap(bool isInput, uint32_t portIndex, uint8_t *channelMap,
+                                   uint32_t channelMapCapacity) const noexcept override
+    {
+        const auto *map = surroundMapFor(portChannels);
+        if (portIndex != 0 || !map)
+            return 0;
+        auto n = std::min(portChannels, channelMapCapacity);
+        std::copy(map, map + n, channelMap);
+        return n;
+    }
+
     bool implementsState() const noexcept override { return true; }
+    // Reused across saves and loads, since some hosts snapshot state on every edit
+    std::vector<uint8_t> stateBuffer;
+
     bool stateSave(const clap_ostream *ostream) noexcept override
     {
         // engine->prepForStream();
-        return sst::plugininfra::patch_support::patchToOutStream(asProcessor()->patch, ostream);
+        // A load the audio thread hasn't adopted yet is the state the host expects back
+        const float *values = loadedState.pending() ? lastLoadedValues.values : nullptr;
+        shared::patchToBinary(asProcessor()->patch, stateBuffer, values);
+        return shared::writeWholeStream(ostream, stateBuffer);
     }
     bool stateLoad(const clap_istream *istream) noexcept override
     {
-        if (!sst::plugininfra::patch_support::inStreamToPatch(istream, asProcessor()->patch))
+        if (!shared::readWholeStream(istream, stateBuffer))
+            return false;
+
+        // Parse into a patch of our own, so the audio thread never sees a half loaded state
+        typename Processor::patch_t loaded;
+        auto readXml = [](const clap_istream *is, auto &p)
+        {
+            // Projects saved before the binary format; these get rewritten on the next save
+            SPLLOG("Loading xml state");
+            return sst::plugininfra::patch_support::inStreamToPatch(is, p);
+        };
+        if (!shared::stateToPatch(stateBuffer, loaded, readXml))
             return false;
 
-        for (auto &[id, p] : asProcessor()->patch.paramMap)
+        auto &patch = asProcessor()->patch;
+        std::memcpy(patch.name, loaded.name, sizeof(patch.name));
+
+        if (!isActive())
         {
-            p->snap();
+            // Nothing is processing, so apply it here and jump straight to the new values.
+            // A snapshot published before a deactivate is older than this load, so drop
+            // it rather than let the next block adopt it over the top.
+            loadedState.consume();
+            for (auto i = 0U; i < patch.params.size(); ++i)
+            {
+                patch.params[i]->value = loaded.params[i]->value;
+                patch.params[i]->snap();
+            }
+            pushFullUIRefresh();
+            _host.paramsRescan(CLAP_PARAM_RESCAN_VALUES);
+            return true;
         }
 
-        pushFullUIRefresh();
-        _host.paramsRescan(CLAP_PARAM_RESCAN_VALUES);
+        for (auto i = 0U; i < patch.params.size(); ++i)
+            lastLoadedValues.values[i] = loaded.params[i]->value;
+        loadedState.writeSlot() = lastLoadedValues;
+        loadedState.publish();
+
+        // A host which isn't calling process still flushes, and we adopt the state there
         _host.paramsRequestFlush();
         return true;
     }
 
+    /*
+     * A state load while active is handed over as a snapshot of every param value, which
+     * the audio thread picks up at the top of its next block. Continuous params glide to
+     * their new values over the usual smoothing time rather than jumping, which keeps
+     * preset changes during playback from clicking. The host is told to rescan once the
+     * values are really in place.
+     */
+    struct ParamSnapshot
+    {
+        float values[SmoothingBank::maxParams]{};
+    };
+    shared::TripleBuffer<ParamSnapshot> loadedState;
+    std::atomic<bool> loadedStateAdopted{false};
+    // The main thread's copy of what it last published, for a save which beats the adopt
+    ParamSnapshot lastLoadedValues;
+
+    void adoptLoadedState()
+    {
+        auto *snapshot = loadedState.consume();
+        if (!snapshot)
+            return;
+
+        const auto &params = asProcessor()->patch.params;
+        for (auto i = 0U; i < params.size(); ++i)
+        {
+            params[i]->value = snapshot->values[i];
+            params[i]->setTarget(snapshot->values[i]);
+        }
+        pushFullUIRefresh();
+
+        loadedStateAdopted.store(true, std::memory_order_release);
+        _host.requestCallback();
+    }
+
     bool handleEvent(const clap_event_header_t *nextEvent)
     {
         auto res = true;
@@ -246,18 +1066,16 @@ struct ProcessorShim : plugHelper_t, sst::clap_juce_shim::EditorProvider
             case CLAP_EVENT_PARAM_VALUE:
             {
                 auto pevt = reinterpret_cast<const clap_event_param_value_t *>(nextEvent);
-                auto par =
-                    sst::plugininfra::patch_support::paramFromClapEvent<typename Processor::param_t,
-                                                                        clap_event_param_value_t>(
-                        pevt, asProcessor()->patch);
+                auto par = pevt->cookie ? static_cast<ParamWithLag *>(pevt->cookie)
+                                        : paramFromId(pevt->param_id);
                 if (par)
                 {
                     par->value = pevt->value;
-                    par->lag.setTarget(pevt->value);
+                    par->setTarget(pevt->value);
 
-                    shared::AudioToUIMsg au{shared::AudioToUIMsg::UPDATE_PARAM, par->meta.id,
-                                            par->value};
-                    audioToUi.push(au);
+                    // The bank index is the param's dense index, see ParamMailbox
+                    if (isEditorAttached)
+                        paramMailbox.post(par->bankIndex, par->value);
                 }
             }
             break;
@@ -14,6 +14,7 @@
 #include <cmath>
 
 #include "sapphire_lnf.h"
+#include "graphics_resources.h"
 
 using juce::Colour;
 using juce::Point;
@@ -22,13 +23,28 @@ using juce::Slider;
 namespace sapphire_plugins::shared
 {
 
-LookAndFeel::LookAndFeel(std::unique_ptr<juce::Drawable> knob,
-                         std::unique_ptr<juce::Drawable> marker)
-    : knob_(std::move(knob)), knob_marker_(std::move(marker)), rotary_scale_factor_(0)
+LookAndFeel::LookAndFeel(std::shared_ptr<const juce::Drawable> knob,
+                         std::shared_ptr<const juce::Drawable> marker)
+    : knob_(std::move(knob)), knob_marker_(std::move(marker))
 {
     setColour(Slider::thumbColourId, Colour(171, 157, 74));
 }
 
+std::shared_ptr<LookAndFeel> getSharedLookAndFeel()
+{
+    static std::weak_ptr<LookAndFeel> shared;
+
+    auto res = shared.lock();
+    if (!res)
+    {
+        res = std::make_shared<LookAndFeel>(getSharedDrawable("res/knob_graphics/knob.svg"),
+                                            getSharedDrawable("res/knob_graphics/knob-marker.svg"));
+        shared = res;
+        pinGraphicsResource(res);
+    }
+    return res;
+}
+
 void LookAndFeel::drawLinearSlider(juce::Graphics &g, int x, int y, int width, int height,
                                    float sliderPos, float minSliderPos, float maxSliderPos,
                                    const Slider::SliderStyle style, Slider &slider)
@@ -146,19 +162,17 @@ void LookAndFeel::drawRotarySlider(juce::Graphics &g, int x, int y, int width, i
     const int sheight = height * sf;
     const float xmid = float(x + width) / 2.f;
     const float ymid = float(y + width) / 2.f;
-    if (sf != rotary_scale_factor_)
+    auto &knob_image = knob_cache_[{sf, width, height}];
+    if (!knob_image.isValid())
     {
-        // Must recreate and recache the SVG image.
-        knob_cache_ =
-            std::make_unique<juce::Image>(juce::Image::ARGB, width * sf, height * sf, true);
-        juce::Graphics cg(*knob_cache_);
+        // First time at this size and scale, so render the SVG into the cache.
+        knob_image = juce::Image(juce::Image::ARGB, swidth, sheight, true);
+        juce::Graphics cg(knob_image);
         // Opacities taken from the SVG files, since Juce isn't smart enough to just use them, sigh.
         knob_->drawWithin(cg, juce::Rectangle{0, 0, swidth, sheight}.toFloat(),
                           juce::RectanglePlacement(), 1.f);
         knob_marker_->drawWithin(cg, juce::Rectangle{0, 0, swidth, sheight}.toFloat(),
                                  juce::RectanglePlacement(), 1.f);
-
-        rotary_scale_factor_ = sf;
     }
 
     // sliderPos is in range [0,1]. Map it onto the start/end angles. 0.5 should be noon by default.
@@ -167,7 +181,7 @@ void LookAndFeel::drawRotarySlider(juce::Graphics &g, int x, int y, int width, i
     auto rotation = juce::AffineTransform::rotation(rads, xmid, ymid);
     g.addTransform(rotation);
 #if 1
-    g.drawImage(*knob_cache_, x, y, width, height, 0, 0, swidth, sheight);
+    g.drawImage(knob_image, x, y, width, height, 0, 0, swidth, sheight);
 #else
     // Maybe do this instead, and set to a buffered image at the component level.
     knob_->drawWithin(g, juce::Rectangle{x, y, width, height}.toFloat(), juce::RectanglePlacement(),
@@ -14,7 +14,9 @@
 #ifndef SAPPHIRE_PLUGINS_SHARED_SAPPHIRE_LNF_H
 #define SAPPHIRE_PLUGINS_SHARED_SAPPHIRE_LNF_H
 
+#include <map>
 #include <memory>
+#include <tuple>
 #include "juce_gui_basics/juce_gui_basics.h"
 
 namespace sapphire_plugins::shared
@@ -22,7 +24,8 @@ namespace sapphire_plugins::shared
 class LookAndFeel : public juce::LookAndFeel_V4
 {
   public:
-    LookAndFeel(std::unique_ptr<juce::Drawable> knob, std::unique_ptr<juce::Drawable> marker);
+    LookAndFeel(std::shared_ptr<const juce::Drawable> knob,
+                std::shared_ptr<const juce::Drawable> marker);
 
     void drawLinearSlider(juce::Graphics &g, int x, int y, int width, int height, float sliderPos,
                           float minSliderPos, float maxSliderPos,
@@ -35,12 +38,18 @@ class LookAndFeel : public juce::LookAndFeel_V4
     juce::Slider::SliderLayout getSliderLayout(juce::Slider &slider) override;
 
   private:
-    std::unique_ptr<juce::Drawable> knob_;
-    std::unique_ptr<juce::Drawable> knob_marker_;
-    std::unique_ptr<juce::Image> knob_cache_;
+    std::shared_ptr<const juce::Drawable> knob_;
+    std::shared_ptr<const juce::Drawable> knob_marker_;
 
-    int rotary_scale_factor_;
+    // Rasterized knobs keyed by (scale factor, width, height), since every editor shares us
+    std::map<std::tuple<int, int, int>, juce::Image> knob_cache_;
 };
+
+/*
+ * One LookAndFeel, with its knob images, for every open editor of every plugin in the
+ * process. It is released when the last editor holding it closes.
+ */
+std::shared_ptr<LookAndFeel> getSharedLookAndFeel();
 } // namespace sapphire_plugins::shared
 
 #endif // SAPPHIRE_PLUGINS_SHARED_SAPPHIRE_LNF_H
@@ -0,0 +1,94 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#ifndef SAPPHIRE_PLUGINS_SHARED_SCRATCH_ARENA_H
+#define SAPPHIRE_PLUGINS_SHARED_SCRATCH_ARENA_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace sapphire_plugins::shared
+{
+/*
+ * A per-instance bump allocator for audio thread buffers. The processor sizes it
+ * once in activate() from maxFrameCount, carves out every buffer it needs and then
+ * locks it. Nothing is handed out while locked, so the process() path never touches
+ * the heap. Every allocation is aligned to a cache line.
+ */
+struct ScratchArena
+{
+    static constexpr size_t alignment{64};
+
+    template <typename T> static constexpr size_t bytesFor(size_t count)
+    {
+        return (count * sizeof(T) + alignment - 1) & ~(alignment - 1);
+    }
+
+    void reserve(size_t bytes)
+    {
+        assert(!locked);
+        if (bytes > capacity)
+        {
+            storage = std::make_unique<uint8_t[]>(bytes + alignment);
+            auto addr = reinterpret_cast<uintptr_t>(storage.get());
+            base = storage.get() + ((alignment - (addr & (alignment - 1))) & (alignment - 1));
+            capacity = bytes;
+        }
+        used = 0;
+    }
+
+    template <typename T> T *allocate(size_t count)
+    {
+        assert(!locked);
+        auto sz = bytesFor<T>(count);
+        if (used + sz > capacity)
+        {
+            assert(false);
+            return nullptr;
+        }
+        auto res = base + used;
+        std::memset(res, 0, sz);
+        used += sz;
+        highWaterMark = std::max(highWaterMark, used);
+        return reinterpret_cast<T *>(res);
+    }
+
+    void lock() { locked = true; }
+    void unlock() { locked = false; }
+
+    void release()
+    {
+        assert(!locked);
+        storage.reset();
+        base = nullptr;
+        capacity = 0;
+        used = 0;
+    }
+
+    size_t capacity{0};
+    size_t used{0};
+    size_t highWaterMark{0};
+
+  private:
+    std::unique_ptr<uint8_t[]> storage;
+    uint8_t *base{nullptr};
+    bool locked{false};
+};
+} // namespace sapphire_plugins::shared
+
+#endif // SCRATCH_ARENA_H
@@ -0,0 +1,121 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#include "simd_dispatch.h"
+#include "configuration.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#if SAPPHIRE_SIMD_X86 && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace sapphire_plugins::shared
+{
+namespace
+{
+#if SAPPHIRE_SIMD_X86
+const SimdKernels kernelsByLevel[] = {
+    {simd_generic::firAccumulate, simd_generic::meshSpringForces, simd_generic::meshIntegrate,
+     simd_generic::meshLaneSpringForces},
+    {simd_avx2::firAccumulate, simd_avx2::meshSpringForces, simd_avx2::meshIntegrate,
+     simd_avx2::meshLaneSpringForces},
+    {simd_avx512::firAccumulate, simd_avx512::meshSpringForces, simd_avx512::meshIntegrate,
+     simd_avx512::meshLaneSpringForces},
+};
+#else
+const SimdKernels kernelsByLevel[] = {
+    {simd_generic::firAccumulate, simd_generic::meshSpringForces, simd_generic::meshIntegrate,
+     simd_generic::meshLaneSpringForces},
+};
+#endif
+static constexpr auto numLevels = sizeof(kernelsByLevel) / sizeof(kernelsByLevel[0]);
+
+SimdLevel currentLevel{SimdLevel::Generic};
+const SimdKernels *currentKernels{&kernelsByLevel[0]};
+
+SimdLevel detectSimdLevel()
+{
+#if SAPPHIRE_SIMD_X86
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 1);
+    bool osxsave = regs[2] & (1 << 27);
+    if (!osxsave)
+        return SimdLevel::Generic;
+
+    auto xcr0 = _xgetbv(0);
+    __cpuidex(regs, 7, 0);
+    bool avx2 = (regs[1] & (1 << 5)) && (xcr0 & 0x6) == 0x6;
+    bool avx512 = (regs[1] & (1 << 16)) && (xcr0 & 0xe6) == 0xe6;
+#else
+    __builtin_cpu_init();
+    bool avx2 = __builtin_cpu_supports("avx2");
+    bool avx512 = __builtin_cpu_supports("avx512f");
+#endif
+    if (avx512)
+        return SimdLevel::AVX512;
+    if (avx2)
+        return SimdLevel::AVX2;
+#endif
+    return SimdLevel::Generic;
+}
+} // namespace
+
+const char *simdLevelName(SimdLevel level)
+{
+    switch (level)
+    {
+    case SimdLevel::Generic:
+        return "generic";
+    case SimdLevel::AVX2:
+        return "avx2";
+    case SimdLevel::AVX512:
+        return "avx512";
+    }
+    return "unknown";
+}
+
+void initSimdDispatch()
+{
+    auto level = detectSimdLevel();
+    auto detected = level;
+
+    if (auto forced = std::getenv("SAPPHIRE_SIMD_LEVEL"))
+    {
+        for (auto l = 0U; l < numLevels; ++l)
+        {
+            if (std::strcmp(forced, simdLevelName((SimdLevel)l)) != 0)
+                continue;
+            if ((SimdLevel)l <= detected)
+                level = (SimdLevel)l;
+            else
+                SPLLOG("SAPPHIRE_SIMD_LEVEL=" << forced << " is not supported on this cpu");
+        }
+    }
+
+    if ((uint32_t)level >= numLevels)
+        level = (SimdLevel)(numLevels - 1);
+
+    currentLevel = level;
+    currentKernels = &kernelsByLevel[(uint32_t)level];
+    SPLLOG("SIMD kernels: " << simdLevelName(level) << " (cpu supports "
+                            << simdLevelName(detected) << ")");
+}
+
+SimdLevel activeSimdLevel() { return currentLevel; }
+
+const SimdKernels &simdKernels() { return *currentKernels; }
+} // namespace sapphire_plugins::shared
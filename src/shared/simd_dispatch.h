@@ -0,0 +1,129 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#ifndef SAPPHIRE_PLUGINS_SHARED_SIMD_DISPATCH_H
+#define SAPPHIRE_PLUGINS_SHARED_SIMD_DISPATCH_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace sapphire_plugins::shared
+{
+/*
+ * The oversampler's FIR loop and the in-tree mass spring mesh kernels live in
+ * simd_kernels.cpp, which the build compiles once per instruction set level (see
+ * SAPPHIRE_SIMD_LEVELS in CMakeLists.txt). initSimdDispatch() runs from clap_init, asks
+ * the cpu what it supports and points simdKernels() at the widest build it can run.
+ * Setting SAPPHIRE_SIMD_LEVEL to generic, avx2 or avx512 in the environment forces a
+ * lower level for testing.
+ *
+ * There is no separate SSE4.2 level. On Linux the whole build already targets nehalem,
+ * and MSVC has no SSE4.2 code generation switch, so it would only duplicate generic.
+ *
+ * Everything built per level has floating point contraction off. The kernels here only
+ * vectorize across independent outputs, springs which share no ball or the lanes of a
+ * lane mesh, and the engines are scalar code the compiler may only vectorize without
+ * reassociating, so every level produces bit identical results on a given machine.
+ */
+enum struct SimdLevel : uint32_t
+{
+    Generic,
+    AVX2,
+    AVX512
+};
+
+/*
+ * One colour of a spring mesh, with the ball state as separate x, y and z arrays. No ball
+ * appears twice among a colour's endpoints, so its springs can scatter their forces in
+ * any order.
+ */
+struct MeshSpringBatch
+{
+    const uint32_t *ballA, *ballB;
+    const float *restLength;
+    uint32_t count;
+};
+
+// How many meshes with the same springs a lane mesh runs side by side
+static constexpr uint32_t meshLanes{4};
+
+/*
+ * Ball state as separate x, y and z arrays, one float per ball. In a lane mesh each ball
+ * has meshLanes floats in a row on each axis, and balls counts the floats.
+ */
+struct MeshState
+{
+    float *px, *py, *pz;
+    float *vx, *vy, *vz;
+    float *fx, *fy, *fz;
+    const float *invMass;
+    uint32_t balls;
+};
+
+using firAccumulate_t = void (*)(float *acc, const float *x, const float *coef, int taps,
+                                 uint32_t n);
+using meshSpringForces_t = void (*)(const MeshSpringBatch &springs, float stiffness,
+                                    const MeshState &mesh);
+using meshIntegrate_t = void (*)(const MeshState &mesh, float dt, float damp);
+using meshLaneSpringForces_t = void (*)(const MeshSpringBatch &springs, const float *stiffness,
+                                        const MeshState &mesh);
+
+struct SimdKernels
+{
+    // acc[i] += sum over j of coef[j] * x[i - j], for i in [0, n)
+    firAccumulate_t firAccumulate;
+    // f[a] += k (|d| - rest) d / |d| and f[b] -= the same, where d = p[b] - p[a]
+    meshSpringForces_t meshSpringForces;
+    // v = damp v + dt f / m, then p += dt v, for every ball
+    meshIntegrate_t meshIntegrate;
+    // meshSpringForces on a lane mesh, with stiffness[lane] for each lane. The springs go
+    // in order, so they may share balls.
+    meshLaneSpringForces_t meshLaneSpringForces;
+};
+
+#define SAPPHIRE_DECLARE_SIMD_KERNELS(ns)                                                          \
+    namespace ns                                                                                   \
+    {                                                                                              \
+    void firAccumulate(float *acc, const float *x, const float *coef, int taps, uint32_t n);       \
+    void meshSpringForces(const MeshSpringBatch &springs, float stiffness,                         \
+                          const MeshState &mesh);                                                  \
+    void meshIntegrate(const MeshState &mesh, float dt, float damp);                               \
+    void meshLaneSpringForces(const MeshSpringBatch &springs, const float *stiffness,              \
+                              const MeshState &mesh);                                              \
+    }
+
+SAPPHIRE_DECLARE_SIMD_KERNELS(simd_generic)
+#if SAPPHIRE_SIMD_X86
+SAPPHIRE_DECLARE_SIMD_KERNELS(simd_avx2)
+SAPPHIRE_DECLARE_SIMD_KERNELS(simd_avx512)
+#endif
+
+void initSimdDispatch();
+SimdLevel activeSimdLevel();
+const char *simdLevelName(SimdLevel level);
+const SimdKernels &simdKernels();
+
+/*
+ * The Elastika, Galaxy and Gravy engines are also built once per level, each behind a
+ * small virtual interface with a factory in every level's namespace. Given those
+ * factories in SimdLevel order, this returns the one for the level in use.
+ */
+template <typename Factory, size_t N> Factory forActiveLevel(const Factory (&byLevel)[N])
+{
+    return byLevel[std::min<size_t>((size_t)activeSimdLevel(), N - 1)];
+}
+} // namespace sapphire_plugins::shared
+
+#endif // SIMD_DISPATCH_H
@@ -0,0 +1,256 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+/*
+ * This file is compiled once per level with SAPPHIRE_SIMD_NS set to the namespace for
+ * that level and the matching instruction set flags. Keep the loops simple enough for
+ * the compiler to vectorize, and don't reorder any sums, so the levels stay identical.
+ * sqrt and division are correctly rounded at every width, so they are safe to use.
+ */
+
+#include "shared/simd_dispatch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifndef SAPPHIRE_SIMD_NS
+#error "simd_kernels.cpp needs SAPPHIRE_SIMD_NS from the build"
+#endif
+
+// Tells the compiler a loop's iterations don't depend on each other through memory
+#if defined(_MSC_VER) && !defined(__clang__)
+#define SAPPHIRE_IVDEP __pragma(loop(ivdep))
+#elif defined(__clang__)
+#define SAPPHIRE_IVDEP _Pragma("clang loop vectorize(assume_safety)")
+#else
+#define SAPPHIRE_IVDEP _Pragma("GCC ivdep")
+#endif
+
+namespace sapphire_plugins::shared::SAPPHIRE_SIMD_NS
+{
+void firAccumulate(float *__restrict acc, const float *x, const float *coef, int taps,
+                   uint32_t n)
+{
+    for (int j = 0; j < taps; ++j)
+    {
+        const auto c = coef[j];
+        const auto *src = x - j;
+        for (auto i = 0U; i < n; ++i)
+            acc[i] += c * src[i];
+    }
+}
+
+/*
+ * Springs go through in chunks. The first pass gathers each spring's endpoints and works
+ * out its force into contiguous arrays, and the second scatters those onto the balls one
+ * axis and one end at a time. Splitting the ends is safe because a colour touches a ball
+ * at most once, and it leaves every scatter loop a single indexed store, which AVX-512
+ * can turn into scatters. The signed index is what lets gcc use 32 bit offsets. Without
+ * scatter instructions one scalar loop over both ends is cheaper than six.
+ */
+static constexpr uint32_t springChunk{64};
+
+static void springChunkForces(const uint32_t *__restrict a, const uint32_t *__restrict b,
+                              const float *__restrict rest, uint32_t n, float stiffness,
+                              const float *__restrict px, const float *__restrict py,
+                              const float *__restrict pz, float *__restrict tx,
+                              float *__restrict ty, float *__restrict tz)
+{
+    for (auto i = 0U; i < n; ++i)
+    {
+        const auto ia = a[i], ib = b[i];
+        const auto dx = px[ib] - px[ia];
+        const auto dy = py[ib] - py[ia];
+        const auto dz = pz[ib] - pz[ia];
+        const auto len = std::sqrt(dx * dx + dy * dy + dz * dz);
+        // Divide unconditionally and select afterwards, so the loop has no branch
+        auto s = stiffness * (len - rest[i]) / (len > 0.f ? len : 1.f);
+        s = len > 0.f ? s : 0.f;
+        tx[i] = s * dx;
+        ty[i] = s * dy;
+        tz[i] = s * dz;
+    }
+}
+
+#if defined(__AVX512F__)
+static void scatterAdd(const uint32_t *__restrict idx, const float *__restrict t, uint32_t n,
+                       float *__restrict f)
+{
+    SAPPHIRE_IVDEP
+    for (auto i = 0U; i < n; ++i)
+        f[(int32_t)idx[i]] += t[i];
+}
+
+static void scatterSub(const uint32_t *__restrict idx, const float *__restrict t, uint32_t n,
+                       float *__restrict f)
+{
+    SAPPHIRE_IVDEP
+    for (auto i = 0U; i < n; ++i)
+        f[(int32_t)idx[i]] -= t[i];
+}
+#endif
+
+void meshSpringForces(const MeshSpringBatch &springs, float stiffness, const MeshState &mesh)
+{
+    alignas(64) float tx[springChunk], ty[springChunk], tz[springChunk];
+    for (auto start = 0U; start < springs.count; start += springChunk)
+    {
+        const auto n = std::min(springChunk, springs.count - start);
+        const auto *a = springs.ballA + start;
+        const auto *b = springs.ballB + start;
+        springChunkForces(a, b, springs.restLength + start, n, stiffness, mesh.px, mesh.py,
+                          mesh.pz, tx, ty, tz);
+#if defined(__AVX512F__)
+        scatterAdd(a, tx, n, mesh.fx);
+        scatterAdd(a, ty, n, mesh.fy);
+        scatterAdd(a, tz, n, mesh.fz);
+        scatterSub(b, tx, n, mesh.fx);
+        scatterSub(b, ty, n, mesh.fy);
+        scatterSub(b, tz, n, mesh.fz);
+#else
+        for (auto i = 0U; i < n; ++i)
+        {
+            mesh.fx[a[i]] += tx[i];
+            mesh.fy[a[i]] += ty[i];
+            mesh.fz[a[i]] += tz[i];
+            mesh.fx[b[i]] -= tx[i];
+            mesh.fy[b[i]] -= ty[i];
+            mesh.fz[b[i]] -= tz[i];
+        }
+#endif
+    }
+}
+
+// One axis at a time, so the compiler sees restrict parameters and needs no alias checks
+static void integrateAxis(float *__restrict p, float *__restrict v, const float *__restrict f,
+                          const float *__restrict invMass, float dt, float damp, uint32_t n)
+{
+    for (auto i = 0U; i < n; ++i)
+    {
+        v[i] = damp * v[i] + (dt * invMass[i]) * f[i];
+        p[i] += dt * v[i];
+    }
+}
+
+void meshIntegrate(const MeshState &mesh, float dt, float damp)
+{
+    integrateAxis(mesh.px, mesh.vx, mesh.fx, mesh.invMass, dt, damp, mesh.balls);
+    integrateAxis(mesh.py, mesh.vy, mesh.fy, mesh.invMass, dt, damp, mesh.balls);
+    integrateAxis(mesh.pz, mesh.vz, mesh.fz, mesh.invMass, dt, damp, mesh.balls);
+}
+
+/*
+ * A lane mesh keeps each ball's lanes in a row. A chunk of springs has its endpoints'
+ * lanes copied out whole into contiguous arrays, so the force pass is one flat loop over
+ * springs and lanes with the arithmetic of springChunkForces, and it vectorizes at any
+ * width. The copies are memcpy so the compiler moves each ball's lanes as one vector
+ * rather than gathering across springs. The forces go back spring by spring, which keeps
+ * each ball's sum in spring order.
+ */
+static constexpr uint32_t laneChunk{16};
+static constexpr uint32_t laneChunkFloats{laneChunk * meshLanes};
+static constexpr size_t laneBytes{meshLanes * sizeof(float)};
+
+struct LaneChunk
+{
+    alignas(64) float ax[laneChunkFloats], ay[laneChunkFloats], az[laneChunkFloats];
+    alignas(64) float bx[laneChunkFloats], by[laneChunkFloats], bz[laneChunkFloats];
+    alignas(64) float rest[laneChunkFloats], stiffness[laneChunkFloats];
+    alignas(64) float tx[laneChunkFloats], ty[laneChunkFloats], tz[laneChunkFloats];
+};
+
+static void laneChunkForces(LaneChunk &c, uint32_t n)
+{
+    float *__restrict tx = c.tx;
+    float *__restrict ty = c.ty;
+    float *__restrict tz = c.tz;
+    for (auto j = 0U; j < n; ++j)
+    {
+        const auto dx = c.bx[j] - c.ax[j];
+        const auto dy = c.by[j] - c.ay[j];
+        const auto dz = c.bz[j] - c.az[j];
+        const auto len = std::sqrt(dx * dx + dy * dy + dz * dz);
+        auto s = c.stiffness[j] * (len - c.rest[j]) / (len > 0.f ? len : 1.f);
+        s = len > 0.f ? s : 0.f;
+        tx[j] = s * dx;
+        ty[j] = s * dy;
+        tz[j] = s * dz;
+    }
+}
+
+/*
+ * Each ball's lanes are all read before any is written, so the compiler can move them as
+ * one vector without proving anything about aliasing, which it won't do for pointers
+ * computed in a loop.
+ */
+static void addLanes(float *f, const float *t)
+{
+    float r[meshLanes];
+    for (auto l = 0U; l < meshLanes; ++l)
+        r[l] = f[l] + t[l];
+    std::memcpy(f, r, laneBytes);
+}
+
+static void subLanes(float *f, const float *t)
+{
+    float r[meshLanes];
+    for (auto l = 0U; l < meshLanes; ++l)
+        r[l] = f[l] - t[l];
+    std::memcpy(f, r, laneBytes);
+}
+
+static void scatterLanes(const uint32_t *a, const uint32_t *b, const float *t, uint32_t n,
+                         float *f)
+{
+    for (auto i = 0U; i < n; ++i)
+    {
+        addLanes(f + (size_t)a[i] * meshLanes, t + i * meshLanes);
+        subLanes(f + (size_t)b[i] * meshLanes, t + i * meshLanes);
+    }
+}
+
+void meshLaneSpringForces(const MeshSpringBatch &springs, const float *stiffness,
+                          const MeshState &mesh)
+{
+    LaneChunk c;
+    for (auto j = 0U; j < laneChunkFloats; ++j)
+        c.stiffness[j] = stiffness[j % meshLanes];
+
+    for (auto start = 0U; start < springs.count; start += laneChunk)
+    {
+        const auto n = std::min(laneChunk, springs.count - start);
+        const auto *a = springs.ballA + start;
+        const auto *b = springs.ballB + start;
+        for (auto i = 0U; i < n; ++i)
+        {
+            const auto ia = a[i] * meshLanes, ib = b[i] * meshLanes;
+            const auto j = i * meshLanes;
+            std::memcpy(c.ax + j, mesh.px + ia, laneBytes);
+            std::memcpy(c.ay + j, mesh.py + ia, laneBytes);
+            std::memcpy(c.az + j, mesh.pz + ia, laneBytes);
+            std::memcpy(c.bx + j, mesh.px + ib, laneBytes);
+            std::memcpy(c.by + j, mesh.py + ib, laneBytes);
+            std::memcpy(c.bz + j, mesh.pz + ib, laneBytes);
+            const auto r = springs.restLength[start + i];
+            for (auto l = 0U; l < meshLanes; ++l)
+                c.rest[j + l] = r;
+        }
+        laneChunkForces(c, n * meshLanes);
+        scatterLanes(a, b, c.tx, n, mesh.fx);
+        scatterLanes(a, b, c.ty, n, mesh.fy);
+        scatterLanes(a, b, c.tz, n, mesh.fz);
+    }
+}
+} // namespace sapphire_plugins::shared::SAPPHIRE_SIMD_NS
@@ -0,0 +1,130 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#ifndef SAPPHIRE_PLUGINS_SHARED_SMOOTHING_BANK_H
+#define SAPPHIRE_PLUGINS_SHARED_SMOOTHING_BANK_H
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace sapphire_plugins::shared
+{
+inline uint32_t lowestSetBit(uint64_t m)
+{
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward64(&idx, m);
+    return (uint32_t)idx;
+#else
+    return (uint32_t)__builtin_ctzll(m);
+#endif
+}
+
+/*
+ * All the one pole parameter lags for a plugin instance, stored as dense arrays
+ * rather than inside each Param. Only lags which are still moving have their bit
+ * set in the active mask, so a bank where nothing is being automated costs a
+ * single compare per smoothing block. The changed mask accumulates every lag whose
+ * current value moved until someone consumes it.
+ */
+struct SmoothingBank
+{
+    static constexpr size_t maxParams{64};
+
+    alignas(16) float current[maxParams]{};
+    alignas(16) float target[maxParams]{};
+    alignas(16) float coef[maxParams]{};
+    uint64_t active{0};
+    uint64_t changed{0};
+    uint32_t count{0};
+
+    // Once a lag is this close to its target, relative to the target's size, we snap
+    // it there and stop updating it
+    static constexpr float settleEpsilon{1e-6f};
+
+    uint32_t add(float value)
+    {
+        assert(count < maxParams);
+        auto idx = count++;
+        current[idx] = value;
+        target[idx] = value;
+        coef[idx] = 1.f;
+        return idx;
+    }
+
+    void setRateInMilliseconds(double ms, double sampleRate, double blockSize)
+    {
+        auto c = (float)(1.0 - std::exp(-blockSize / (ms * 0.001 * sampleRate)));
+        for (auto i = 0U; i < count; ++i)
+            coef[i] = c;
+    }
+
+    void setTarget(uint32_t idx, float value)
+    {
+        target[idx] = value;
+        if (current[idx] != value)
+            active |= (uint64_t)1 << idx;
+    }
+
+    void snapTo(uint32_t idx, float value)
+    {
+        current[idx] = value;
+        target[idx] = value;
+        active &= ~((uint64_t)1 << idx);
+        changed |= (uint64_t)1 << idx;
+    }
+
+    void markAllChanged()
+    {
+        changed = count == maxParams ? ~(uint64_t)0 : (((uint64_t)1 << count) - 1);
+    }
+
+    bool isSettled() const { return active == 0; }
+
+    void process()
+    {
+        auto m = active;
+        changed |= m;
+        while (m)
+        {
+            auto idx = lowestSetBit(m);
+            m &= m - 1;
+
+            auto d = target[idx] - current[idx];
+            auto next = current[idx] + coef[idx] * d;
+            // A small coefficient against a large value can stop moving before it gets
+            // within epsilon, so a step which rounds away to nothing also settles
+            if (next == current[idx] ||
+                std::fabs(d) <= settleEpsilon * std::max(1.f, std::fabs(target[idx])))
+            {
+                current[idx] = target[idx];
+                active &= ~((uint64_t)1 << idx);
+            }
+            else
+            {
+                current[idx] = next;
+            }
+        }
+    }
+};
+} // namespace sapphire_plugins::shared
+
+#endif // SMOOTHING_BANK_H
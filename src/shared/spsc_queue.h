@@ -0,0 +1,78 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#ifndef SAPPHIRE_PLUGINS_SHARED_SPSC_QUEUE_H
+#define SAPPHIRE_PLUGINS_SHARED_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+
+namespace sapphire_plugins::shared
+{
+static constexpr size_t cacheLineSize{64};
+
+/*
+ * A bounded single producer single consumer ring. The producer owns head and the
+ * consumer owns tail, and each sits on its own cache line along with that side's cached
+ * copy of the other index, so the two threads only share a line when one of them has
+ * to refresh its view of the other. A full queue drops the push.
+ */
+template <typename T, size_t capacity> struct SpscQueue
+{
+    static_assert(capacity > 0 && (capacity & (capacity - 1)) == 0,
+                  "SpscQueue capacity must be a power of two");
+
+    bool push(const T &item)
+    {
+        auto h = head.load(std::memory_order_relaxed);
+        if (h - producerTail == capacity)
+        {
+            producerTail = tail.load(std::memory_order_acquire);
+            if (h - producerTail == capacity)
+                return false;
+        }
+        items[h & mask] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::optional<T> pop()
+    {
+        auto t = tail.load(std::memory_order_relaxed);
+        if (t == consumerHead)
+        {
+            consumerHead = head.load(std::memory_order_acquire);
+            if (t == consumerHead)
+                return std::nullopt;
+        }
+        auto res = items[t & mask];
+        tail.store(t + 1, std::memory_order_release);
+        return res;
+    }
+
+  private:
+    static constexpr size_t mask{capacity - 1};
+
+    alignas(cacheLineSize) std::atomic<size_t> head{0};
+    size_t producerTail{0};
+
+    alignas(cacheLineSize) std::atomic<size_t> tail{0};
+    size_t consumerHead{0};
+
+    alignas(cacheLineSize) T items[capacity]{};
+};
+} // namespace sapphire_plugins::shared
+
+#endif // SPSC_QUEUE_H
@@ -0,0 +1,62 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#ifndef SAPPHIRE_PLUGINS_SHARED_TRIPLE_BUFFER_H
+#define SAPPHIRE_PLUGINS_SHARED_TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace sapphire_plugins::shared
+{
+/*
+ * Hands the latest value of T from one writer thread to one reader thread without either
+ * side ever waiting. The writer fills its own slot and swaps it into the middle, and the
+ * reader swaps the middle out when it is marked fresh. Publishing twice before the reader
+ * looks just replaces the first value.
+ */
+template <typename T> struct TripleBuffer
+{
+    // Writer side: fill this, then publish()
+    T &writeSlot() { return slots[writeIdx]; }
+
+    void publish()
+    {
+        writeIdx = middle.exchange(writeIdx | freshBit, std::memory_order_acq_rel) & indexMask;
+    }
+
+    // Writer side: true while the last published value is still waiting for the reader
+    bool pending() const { return middle.load(std::memory_order_acquire) & freshBit; }
+
+    // Reader side: returns the newly published value, or nullptr if nothing new arrived
+    const T *consume()
+    {
+        if (!(middle.load(std::memory_order_relaxed) & freshBit))
+            return nullptr;
+        readIdx = middle.exchange(readIdx, std::memory_order_acq_rel) & indexMask;
+        return &slots[readIdx];
+    }
+
+  private:
+    static constexpr uint32_t freshBit{4};
+    static constexpr uint32_t indexMask{3};
+
+    T slots[3]{};
+    uint32_t writeIdx{0};
+    uint32_t readIdx{1};
+    std::atomic<uint32_t> middle{2};
+};
+} // namespace sapphire_plugins::shared
+
+#endif // TRIPLE_BUFFER_H
@@ -29,7 +29,10 @@ struct TubeUnitEditor : public juce::Component
 {
     Patch patchCopy;
 
-    TubeUnitEditor(shared::audioToUIQueue_t &atou, shared::uiToAudioQueue_T &utoa,
+    // The audio thread only sends VU data down audioToUI, param values use the mailbox
+    using editorQueues_t = shared::EditorQueues<64, 1024>;
+
+    TubeUnitEditor(editorQueues_t &queues, shared::ParamMailbox &mailbox,
                    std::function<void()> flushOperator);
     ~TubeUnitEditor();
 
@@ -51,10 +54,12 @@ struct TubeUnitEditor : public juce::Component
     std::unique_ptr<juce::Slider> spring;
     std::unique_ptr<juce::Slider> mix;
 
-    std::unique_ptr<shared::LookAndFeel> lnf;
+    std::shared_ptr<shared::LookAndFeel> lnf;
 
-    shared::audioToUIQueue_t &audioToUI;
-    shared::uiToAudioQueue_T &uiToAudio;
+    editorQueues_t &editorQueues;
+    shared::ParamMailbox &paramMailbox;
+    editorQueues_t::audioToUI_t &audioToUI;
+    editorQueues_t::uiToAudio_t &uiToAudio;
     std::function<void()> flushOperator;
 
     std::unique_ptr<shared::Tooltip> tooltip;
@@ -24,6 +24,7 @@
 #include "tube_unit.h"
 #include "sst/plugininfra/patch-support/patch_base.h"
 #include "shared/param_with_lag.h"
+#include "shared/param_table.h"
 
 namespace sapphire_plugins::tube_unit
 {
@@ -40,8 +41,23 @@ struct Patch : pats::PatchBase<Patch, Param>
     char name[256]{""};
 
     static constexpr uint32_t floatFlags{CLAP_PARAM_IS_AUTOMATABLE};
+    // Params which restart the plugin to take effect can't be automated
+    static constexpr uint32_t restartFlags{CLAP_PARAM_IS_STEPPED | CLAP_PARAM_REQUIRES_PROCESS};
 
-    static md_t floatMd() { return md_t().asFloat().withFlags(floatFlags); }
+    static constexpr shared::ParamTable<10> paramTable{{{
+        {100, "Airflow", 0, 5, 0, floatFlags},
+        {110, "Vortex", 0, 1, 0.5, floatFlags},
+        {120, "Bypass Width", 0.5, 20, 6, floatFlags},
+        {130, "Bypass Center", -10, 10, 0, floatFlags},
+        {140, "Reflection Decay", 0, 1, 0.5, floatFlags},
+        {150, "Reflection Angle", 0, 1, 0.1, floatFlags},
+        {160, "Root Frequency", 0, 8, 2.7279248, floatFlags},
+        {170, "Spring Stiffness", 0, 1, 0.5, floatFlags},
+        {180, "Mix", 0, 1, 1, floatFlags},
+        {190, "Oversampling", 0, 2, 0, restartFlags},
+    }}};
+
+    template <clap_id id> static md_t md() { return shared::metaFor<paramTable, id>(); }
 
     Param airflow;
     Param vortex;
@@ -52,55 +68,17 @@ struct Patch : pats::PatchBase<Patch, Param>
     Param root;
     Param spring;
     Param mix;
+    Param oversampling;
 
     Patch()
-        : pats::PatchBase<Patch, Param>(), airflow(floatMd()
-                                                       .withName("Airflow")
-                                                       .withID(100)
-                                                       .withRange(0, 5)
-                                                       .withDefault(0)
-                                                       .withLinearScaleFormatting("")),
-          vortex(floatMd().withName("Vortex").withID(110).asPercent().withDefault(0.5)),
-          width(floatMd()
-                    .withName("Bypass Width")
-                    .withID(120)
-                    .withRange(0.5, 20)
-                    .withDefault(6)
-                    .withLinearScaleFormatting("")),
-          center(floatMd()
-                     .withName("Bypass Center")
-                     .withID(130)
-                     .withRange(-10, 10)
-                     .withDefault(0.f)
-                     .withLinearScaleFormatting("")),
-          decay(floatMd()
-                    .withName("Reflection Decay")
-                    .withID(140)
-                    .asPercent()
-                    .withDefault(0.5f)),
-          angle(floatMd()
-                    .withName("Reflection Angle")
-                    .withID(150)
-                    .withRange(0., 1.)
-                    .withLinearScaleFormatting("")
-                    .withDefault(0.1f)),
-          root(floatMd()
-                   .withName("Root Frequency")
-                   .withID(160)
-                   .withRange(0., 8.)
-                   .withDefault(2.7279248)
-                   .withATwoToTheBFormatting(4, 1, "hz")),
-          spring(floatMd()
-                   .withName("Spring Stiffness")
-                   .withID(170)
-                   .asPercent()
-                   .withDefault(0.5)),
-          mix(floatMd()
-                   .withName("Mix")
-                   .withID(180)
-                   .withRange(0.0, 1.0)
-                   .withLinearScaleFormatting("")
-                   .withDefault(1.0))
+        : pats::PatchBase<Patch, Param>(), airflow(md<100>().withLinearScaleFormatting("")),
+          vortex(md<110>().asPercent()), width(md<120>().withLinearScaleFormatting("")),
+          center(md<130>().withLinearScaleFormatting("")), decay(md<140>().asPercent()),
+          angle(md<150>().withLinearScaleFormatting("")),
+          root(md<160>().withATwoToTheBFormatting(4, 1, "hz")), spring(md<170>().asPercent()),
+          mix(md<180>().withLinearScaleFormatting("")),
+          oversampling(
+              md<190>().withUnorderedMapFormatting({{0, "Off"}, {1, "2x"}, {2, "4x"}}))
 
     {
         this->pushSingleParam(&airflow);
@@ -112,6 +90,8 @@ struct Patch : pats::PatchBase<Patch, Param>
         this->pushSingleParam(&root);
         this->pushSingleParam(&spring);
         this->pushSingleParam(&mix);
+        this->pushSingleParam(&oversampling);
+        assert(shared::paramsMatchTable(params, paramTable));
 
         onResetToInit = [](auto &patch)
         {
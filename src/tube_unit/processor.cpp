@@ -19,6 +19,8 @@
 #include "patch.h"
 #include "editor.h"
 
+#include <limits>
+
 namespace sapphire_plugins::tube_unit
 {
 
@@ -48,67 +50,73 @@ struct TubeUnitClap : public shared::ProcessorShim<TubeUnitClap>
     using param_t = Param;
     static constexpr bool hasStereoInput{true};
     static constexpr bool hasStereoOutput{true};
+    static constexpr bool supportsOversampling{true};
+    static constexpr bool supportsFixedEngineRate{false};
+    static constexpr double tailSeconds{2.0};
 
     std::unique_ptr<Sapphire::TubeUnitEngine> engine;
     Patch patch;
-    size_t blockPos{0};
 
     TubeUnitClap(const clap_host *h) : shared::ProcessorShim<TubeUnitClap>(getDescriptor(), h)
+    {
+    }
+
+    void createEngine()
     {
         engine = std::make_unique<Sapphire::TubeUnitEngine>();
+        engine->setSampleRate(engineSampleRate);
+    }
+    void releaseEngine() { engine.reset(); }
+
+    void bindEngineSetters()
+    {
+        bindParamToEngine(patch.mix, [](auto &c, float v) { c.engine->setMix(v); });
+        bindParamToEngine(patch.airflow, [](auto &c, float v) { c.engine->setAirflow(v); });
+        bindParamToEngine(patch.vortex, [](auto &c, float v) { c.engine->setVortex(v); });
+        bindParamToEngine(patch.width, [](auto &c, float v) { c.engine->setBypassWidth(v); });
+        bindParamToEngine(patch.center, [](auto &c, float v) { c.engine->setBypassCenter(v); });
+        bindParamToEngine(patch.angle,
+                          [](auto &c, float v) { c.engine->setReflectionAngle(M_PI * v); });
+        bindParamToEngine(patch.decay,
+                          [](auto &c, float v) { c.engine->setReflectionDecay(v); });
+        bindParamToEngine(patch.root, [](auto &c, float v)
+                          { c.engine->setRootFrequency(4 * std::pow(2.f, v)); });
+        bindParamToEngine(patch.spring, [](auto &c, float v)
+                          { c.engine->setSpringConstant(0.005f * std::pow(10.0f, 4.0f * v)); });
+        bindParamToEngine(patch.oversampling, [](auto &c, float) { c.engineRateParamChanged(); });
+    }
+
+    uint32_t requestedOversampling() const
+    {
+        return 1U << (uint32_t)std::round(patch.oversampling.value);
     }
 
-    bool activate(double sampleRate, uint32_t minFrameCount,
-                  uint32_t maxFrameCount) noexcept override
+    // With any airflow the tube makes sound on its own, so it never goes quiet
+    uint32_t tailSamples() const
     {
-        auto res =
-            shared::ProcessorShim<TubeUnitClap>::activate(sampleRate, minFrameCount, maxFrameCount);
-        engine->setSampleRate(sampleRate);
-        return res;
+        if (patch.airflow.value > 0)
+            return std::numeric_limits<uint32_t>::max();
+        return (uint32_t)(sampleRate * tailSeconds);
     }
 
-    clap_process_status process(const clap_process *process) noexcept override
+    void processEngineBlock(float **in, float **out, uint32_t offset, uint32_t frames,
+                            uint32_t)
     {
-        auto ev = process->in_events;
-        auto outq = process->out_events;
-
-        float **in = process->audio_inputs[0].data32;
-        float **out = process->audio_outputs[0].data32;
-
-        shared::processUIQueueFromAudio(this, outq);
-
-        startProcessEventTraversal(ev);
-
-        for (auto s = 0U; s < process->frames_count; ++s)
-        {
-            if (blockPos == 0)
-            {
-                processEventsUpTo(s, ev);
-
-                for (auto &[i, p] : patch.paramMap)
-                    p->lag.process();
-
-                engine->setMix(patch.mix.lag.v);
-                engine->setAirflow(patch.airflow.lag.v);
-                engine->setVortex(patch.vortex.lag.v);
-                engine->setBypassWidth(patch.width.lag.v);
-                engine->setBypassCenter(patch.center.lag.v);
-                engine->setReflectionAngle(M_PI * patch.angle.lag.v);
-                engine->setReflectionDecay(patch.decay.lag.v);
-                engine->setRootFrequency(4 * std::pow(2.f, patch.root.lag.v));
-                engine->setSpringConstant(0.005f * std::pow(10.0f, 4.0f * patch.spring.lag.v));
-            }
-            engine->process(out[0][s], out[1][s], in[0][s], in[1][s]);
-            blockPos = (blockPos + 1) & (smoothingBlock - 1);
-        }
-
-        processEventsUpTo(process->frames_count, ev);
-        return CLAP_PROCESS_CONTINUE;
+        auto &eng = *engine;
+        const float *inL = in[0] + offset, *inR = in[1] + offset;
+        float *outL = out[0] + offset, *outR = out[1] + offset;
+
+        for (auto s = 0U; s < frames; ++s)
+            eng.process(outL[s], outR[s], inL[s], inR[s]);
     }
+
     void reset() noexcept override
     {
         engine->setQuiet(true);
         engine->setQuiet(false);
+        oversampler->reset();
+        smoothing.markAllChanged();
+        quietOutputSamples = 0;
     }
 
     bool handleNonParamEvent(const clap_event_header_t *nextEvent) { return false; }
@@ -0,0 +1,241 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "test_check.h"
+
+#include "shared/binary_state.h"
+
+namespace sps = sapphire_plugins::shared;
+
+/*
+ * Just enough of a patch for the binary reader and writer: params with an id, range,
+ * default and value, a name, and the version hooks. The table stands in for the
+ * plugin's ParamTable, which is the only thing binaryToPatch asks for an index.
+ */
+struct FakeParam
+{
+    struct
+    {
+        uint32_t id;
+        float minVal, maxVal, defaultVal;
+    } meta;
+    float value;
+};
+
+struct FakeTable
+{
+    static constexpr uint32_t ids[3]{10, 20, 30};
+    static constexpr size_t size() { return 3; }
+    static constexpr size_t indexOf(uint32_t id)
+    {
+        for (size_t i = 0; i < size(); ++i)
+            if (ids[i] == id)
+                return i;
+        return size();
+    }
+};
+
+struct FakePatch
+{
+    static constexpr uint32_t patchVersion{3};
+    static constexpr FakeTable paramTable{};
+
+    FakeParam gain{{10, 0.f, 1.f, 0.5f}, 0.5f};
+    FakeParam freq{{20, -5.f, 5.f, 0.f}, 0.f};
+    FakeParam mode{{30, 0.f, 4.f, 1.f}, 1.f};
+    std::vector<FakeParam *> params{&gain, &freq, &mode};
+    char name[256]{"Init"};
+
+    int migratedFrom{-1};
+    float migrateParamValueFromVersion(FakeParam *, float v, uint32_t) { return v * 2; }
+    void migratePatchFromVersion(uint32_t v) { migratedFrom = (int)v; }
+};
+
+// Offsets into the chunk, following the layout comment in binary_state.h
+static constexpr size_t versionAt{4}, patchVersionAt{8}, countAt{12}, nameAt{16};
+static constexpr size_t pairsAt{nameAt + 256};
+
+static void putU32(std::vector<uint8_t> &buf, size_t at, uint32_t v)
+{
+    for (int i = 0; i < 4; ++i)
+        buf[at + i] = (uint8_t)(v >> (8 * i));
+}
+
+static void putFloat(std::vector<uint8_t> &buf, size_t at, float v)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    putU32(buf, at, bits);
+}
+
+static std::vector<uint8_t> savedChunk()
+{
+    FakePatch patch;
+    patch.gain.value = 0.25f;
+    patch.freq.value = -3.5f;
+    patch.mode.value = 4.f;
+    strncpy(patch.name, "Round Trip", sizeof(patch.name));
+    std::vector<uint8_t> buf;
+    sps::patchToBinary(patch, buf);
+    return buf;
+}
+
+static void roundTrip()
+{
+    auto buf = savedChunk();
+    CHECK(sps::isBinaryState(buf));
+    CHECK(buf.size() == pairsAt + 3 * 8);
+
+    FakePatch loaded;
+    CHECK(sps::binaryToPatch(buf, loaded));
+    CHECK(loaded.gain.value == 0.25f);
+    CHECK(loaded.freq.value == -3.5f);
+    CHECK(loaded.mode.value == 4.f);
+    CHECK(std::strcmp(loaded.name, "Round Trip") == 0);
+    CHECK(loaded.migratedFrom == -1);
+
+    // Values handed in override the params', as stateSave does with a pending load
+    FakePatch patch;
+    float values[3]{0.75f, 2.f, 0.f};
+    sps::patchToBinary(patch, buf, values);
+    CHECK(sps::binaryToPatch(buf, loaded));
+    CHECK(loaded.gain.value == 0.75f);
+    CHECK(loaded.freq.value == 2.f);
+    CHECK(loaded.mode.value == 0.f);
+}
+
+static void rejectsTruncated()
+{
+    auto buf = savedChunk();
+    for (size_t len = 0; len < buf.size(); ++len)
+    {
+        std::vector<uint8_t> cut(buf.begin(), buf.begin() + len);
+        FakePatch loaded;
+        loaded.gain.value = 0.9f;
+        CHECK(!sps::binaryToPatch(cut, loaded));
+        // A rejected chunk leaves the patch alone
+        CHECK(loaded.gain.value == 0.9f);
+        CHECK(std::strcmp(loaded.name, "Init") == 0);
+    }
+}
+
+static void rejectsBadMagicAndNewerVersion()
+{
+    auto buf = savedChunk();
+    buf[1] = 'X';
+    FakePatch loaded;
+    CHECK(!sps::isBinaryState(buf));
+    CHECK(!sps::binaryToPatch(buf, loaded));
+
+    buf = savedChunk();
+    putU32(buf, versionAt, sps::binaryStateVersion + 1);
+    CHECK(!sps::binaryToPatch(buf, loaded));
+
+    // A count claiming more pairs than are present is a truncation too
+    buf = savedChunk();
+    putU32(buf, countAt, 4);
+    CHECK(!sps::binaryToPatch(buf, loaded));
+}
+
+static void terminatesOverLongName()
+{
+    FakePatch patch;
+    std::memset(patch.name, 'n', sizeof(patch.name));
+    std::vector<uint8_t> buf;
+    sps::patchToBinary(patch, buf);
+    CHECK(buf[pairsAt - 1] == 0);
+
+    // Someone else's chunk may fill the whole field
+    for (size_t i = 0; i < 256; ++i)
+        buf[nameAt + i] = 'x';
+    FakePatch loaded;
+    CHECK(sps::binaryToPatch(buf, loaded));
+    CHECK(std::strlen(loaded.name) == 255);
+}
+
+static void skipsUnknownIdsAndDefaultsMissing()
+{
+    auto buf = savedChunk();
+    // Replace gain's pair with an id we don't know, so gain is missing from the chunk
+    putU32(buf, pairsAt, 99);
+    // freq out of range clamps, mode non-finite is ignored
+    putFloat(buf, pairsAt + 8 + 4, 50.f);
+    putFloat(buf, pairsAt + 16 + 4, std::numeric_limits<float>::quiet_NaN());
+
+    FakePatch loaded;
+    loaded.gain.value = 0.9f;
+    loaded.mode.value = 3.f;
+    CHECK(sps::binaryToPatch(buf, loaded));
+    CHECK(loaded.gain.value == 0.5f);
+    CHECK(loaded.freq.value == 5.f);
+    CHECK(loaded.mode.value == 1.f);
+}
+
+static void migratesOlderPatchVersions()
+{
+    auto buf = savedChunk();
+    putU32(buf, patchVersionAt, 1);
+    FakePatch loaded;
+    CHECK(sps::binaryToPatch(buf, loaded));
+    CHECK(loaded.migratedFrom == 1);
+    CHECK(loaded.gain.value == 0.5f);
+    CHECK(loaded.freq.value == -5.f);
+}
+
+static void fallsBackToXml()
+{
+    static constexpr char xml[]{"<?xml version=\"1.0\"?><patch name=\"Old\"/>"};
+    std::vector<uint8_t> buf(xml, xml + sizeof(xml) - 1);
+    // Longer than one read chunk, so the stream is read in pieces
+    buf.resize(10000, ' ');
+
+    FakePatch loaded;
+    int xmlReads{0};
+    std::vector<uint8_t> seen;
+    auto readXml = [&](const clap_istream *is, FakePatch &p)
+    {
+        ++xmlReads;
+        strncpy(p.name, "Old", sizeof(p.name));
+        return sps::readWholeStream(is, seen);
+    };
+    CHECK(sps::stateToPatch(buf, loaded, readXml));
+    CHECK(xmlReads == 1);
+    CHECK(seen == buf);
+    CHECK(std::strcmp(loaded.name, "Old") == 0);
+
+    // A binary chunk never reaches the xml reader, even when it fails to parse
+    buf = savedChunk();
+    CHECK(sps::stateToPatch(buf, loaded, readXml));
+    CHECK(xmlReads == 1);
+    buf.resize(pairsAt);
+    CHECK(!sps::stateToPatch(buf, loaded, readXml));
+    CHECK(xmlReads == 1);
+}
+
+int main()
+{
+    roundTrip();
+    rejectsTruncated();
+    rejectsBadMagicAndNewerVersion();
+    terminatesOverLongName();
+    skipsUnknownIdsAndDefaultsMissing();
+    migratesOlderPatchVersions();
+    fallsBackToXml();
+    return sapphire_plugins::tests::failures;
+}
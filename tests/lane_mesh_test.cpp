@@ -0,0 +1,155 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "test_check.h"
+
+#include "elastika/lane_mesh.h"
+#include "elastika/mesh_tiers.h"
+
+namespace sps = sapphire_plugins::shared;
+using namespace sapphire_plugins::elastika;
+
+static constexpr float dt{1.f / 48000.f}, halflife{0.5f};
+static constexpr float laneStiffness[LaneMesh::lanes]{50.f, 100.f, 200.f, 400.f};
+static constexpr float laneSpan[LaneMesh::lanes]{1.f, 1.1f, 0.9f, 1.25f};
+
+static void forceSimdLevel(const char *level)
+{
+#if defined(_WIN32)
+    _putenv_s("SAPPHIRE_SIMD_LEVEL", level);
+#else
+    setenv("SAPPHIRE_SIMD_LEVEL", level, 1);
+#endif
+    sps::initSimdDispatch();
+}
+
+static void placeAnchors(LaneMesh &m, uint32_t lane, const std::vector<MeshBall> &balls,
+                         float span)
+{
+    for (auto i = 0U; i < balls.size(); ++i)
+        if (balls[i].mass == 0.f)
+            m.moveBall(lane, i, span * balls[i].x, span * balls[i].y, balls[i].z);
+}
+
+static void placeAnchors(SoaMesh &m, const std::vector<MeshBall> &balls, float span)
+{
+    for (auto i = 0U; i < balls.size(); ++i)
+        if (balls[i].mass == 0.f)
+            m.moveBall(i, span * balls[i].x, span * balls[i].y, balls[i].z);
+}
+
+/*
+ * Each lane gets its own stiffness, its own anchor ring span and its own ball plucked,
+ * and the same settings go to a SoaMesh of its own. The anchors move again half way
+ * through, as they would under automation.
+ */
+static void lanesMatchSingleMeshesAtEveryLevel()
+{
+    std::vector<MeshBall> balls;
+    std::vector<MeshSpring> springs;
+    makeHexMesh(4, 1.f, 1.f, 0.5f, balls, springs);
+    std::vector<uint32_t> inner;
+    for (auto i = 0U; i < balls.size(); ++i)
+        if (balls[i].mass > 0.f)
+            inner.push_back(i);
+
+    for (auto level : {"generic", "avx2", "avx512"})
+    {
+        forceSimdLevel(level);
+        if (std::strcmp(sps::simdLevelName(sps::activeSimdLevel()), level) != 0)
+            continue;
+
+        LaneMesh lanes;
+        CHECK(lanes.build(balls, springs));
+        SoaMesh single[LaneMesh::lanes];
+        for (auto l = 0U; l < LaneMesh::lanes; ++l)
+        {
+            CHECK(single[l].build(balls, springs));
+            lanes.setStiffness(l, laneStiffness[l]);
+            single[l].setStiffness(laneStiffness[l]);
+            placeAnchors(lanes, l, balls, laneSpan[l]);
+            placeAnchors(single[l], balls, laneSpan[l]);
+
+            const auto pluck = inner[5 * l + 2];
+            const auto &b = balls[pluck];
+            lanes.moveBall(l, pluck, laneSpan[l] * b.x, laneSpan[l] * b.y, 0.05f);
+            single[l].moveBall(pluck, laneSpan[l] * b.x, laneSpan[l] * b.y, 0.05f);
+        }
+
+        for (int s = 0; s < 4000; ++s)
+        {
+            if (s == 2000)
+                for (auto l = 0U; l < LaneMesh::lanes; ++l)
+                {
+                    placeAnchors(lanes, l, balls, 1.2f * laneSpan[l]);
+                    placeAnchors(single[l], balls, 1.2f * laneSpan[l]);
+                }
+            lanes.update(dt, halflife);
+            for (auto &m : single)
+                m.update(dt, halflife);
+        }
+
+        const auto &st = lanes.meshState();
+        bool same{true}, moved{false};
+        for (auto l = 0U; l < LaneMesh::lanes; ++l)
+        {
+            const auto &one = single[l].meshState();
+            for (auto i = 0U; i < lanes.ballCount(); ++i)
+            {
+                const auto at = LaneMesh::slot(l, i);
+                same = same && st.px[at] == one.px[i] && st.py[at] == one.py[i] &&
+                       st.pz[at] == one.pz[i] && st.vz[at] == one.vz[i];
+                moved = moved || one.vz[i] != 0.f;
+            }
+        }
+        CHECK(same);
+        CHECK(moved);
+    }
+    forceSimdLevel("");
+}
+
+static void quietResetsEveryLane()
+{
+    std::vector<MeshBall> balls;
+    std::vector<MeshSpring> springs;
+    makeHexMesh(3, 1.f, 1.f, 0.5f, balls, springs);
+    LaneMesh lanes;
+    CHECK(lanes.build(balls, springs));
+    CHECK(lanes.ballCount() == balls.size() && lanes.springCount() == springs.size());
+    for (auto l = 0U; l < LaneMesh::lanes; ++l)
+        lanes.moveBall(l, 0, 0.f, 0.f, 0.1f * (l + 1));
+    for (int s = 0; s < 100; ++s)
+        lanes.update(dt, halflife);
+
+    lanes.quiet();
+    const auto &st = lanes.meshState();
+    for (auto l = 0U; l < LaneMesh::lanes; ++l)
+        for (auto i = 0U; i < balls.size(); ++i)
+        {
+            const auto at = LaneMesh::slot(l, i);
+            CHECK(st.px[at] == balls[i].x && st.pz[at] == balls[i].z && st.vz[at] == 0.f);
+        }
+}
+
+int main()
+{
+    sps::initSimdDispatch();
+    lanesMatchSingleMeshesAtEveryLevel();
+    quietResetsEveryLane();
+    return sapphire_plugins::tests::failures;
+}
@@ -0,0 +1,134 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "test_check.h"
+
+#include "elastika/mesh_tiers.h"
+
+namespace sps = sapphire_plugins::shared;
+using namespace sapphire_plugins::elastika;
+
+static constexpr float radius{1.f}, density{1.f}, restFraction{0.5f};
+static constexpr float dt{1.f / 48000.f}, halflife{100.f};
+
+/*
+ * Bows the sheet into a dome, which is mostly the lowest drum mode, and counts the zero
+ * crossings of the summed displacement over a second to get its frequency.
+ */
+static double fundamental(MeshTiers &tiers, float span)
+{
+    tiers.quiet();
+    auto &mesh = tiers.active();
+    const auto &st = mesh.meshState();
+    for (auto i = 0U; i < st.balls; ++i)
+    {
+        if (st.invMass[i] == 0.f)
+            continue;
+        auto r = std::sqrt(st.px[i] * st.px[i] + st.py[i] * st.py[i]) / (span * radius);
+        mesh.moveBall(i, st.px[i], st.py[i], 0.01f * std::cos(1.5707963f * r));
+    }
+
+    int crossings{0}, first{-1}, last{0};
+    float prev{0.f};
+    for (int s = 0; s < 48000; ++s)
+    {
+        tiers.update(dt, halflife);
+        float sum{0.f};
+        for (auto i = 0U; i < st.balls; ++i)
+            sum += st.pz[i];
+        if (s > 0 && (sum > 0.f) != (prev > 0.f))
+        {
+            if (first < 0)
+                first = s;
+            last = s;
+            ++crossings;
+        }
+        prev = sum;
+    }
+    if (crossings < 3)
+        return 0.0;
+    return 0.5 * (crossings - 1) / ((last - first) * (double)dt);
+}
+
+static void tiersGetCheaper()
+{
+    MeshTiers tiers;
+    CHECK(tiers.build(radius, density, restFraction));
+    for (auto t = 1U; t < numMeshTiers; ++t)
+    {
+        const auto &fine = tiers.meshFor((MeshTier)(t - 1));
+        const auto &coarse = tiers.meshFor((MeshTier)t);
+        CHECK(coarse.ballCount() < fine.ballCount());
+        CHECK(coarse.springCount() < fine.springCount());
+    }
+}
+
+static void tiersKeepThePitch()
+{
+    MeshTiers tiers;
+    CHECK(tiers.build(radius, density, restFraction));
+    for (auto k : {100.f, 400.f})
+        for (auto span : {1.f, 1.25f})
+        {
+            tiers.setStiffness(k);
+            tiers.setSpan(span);
+            tiers.select(MeshTier::Full);
+            auto full = fundamental(tiers, span);
+            CHECK(full > 0.0);
+            for (auto t : {MeshTier::Medium, MeshTier::Light})
+            {
+                tiers.select(t);
+                auto f = fundamental(tiers, span);
+                CHECK(std::fabs(f / full - 1.0) < 0.03);
+            }
+        }
+}
+
+static void selectKeepsStorageAndSpan()
+{
+    MeshTiers tiers;
+    CHECK(tiers.build(radius, density, restFraction));
+    const float *px[numMeshTiers];
+    for (auto t = 0U; t < numMeshTiers; ++t)
+        px[t] = tiers.meshFor((MeshTier)t).meshState().px;
+
+    tiers.setSpan(1.5f);
+    for (auto t : {MeshTier::Light, MeshTier::Medium, MeshTier::Full, MeshTier::Light})
+    {
+        tiers.select(t);
+        CHECK(tiers.selected() == t);
+        CHECK(tiers.active().meshState().px == px[(uint32_t)t]);
+
+        // Anchors sit on the scaled outer ring, a hexagon whose corners are at the radius
+        const auto &st = tiers.active().meshState();
+        float outer{0.f};
+        for (auto i = 0U; i < st.balls; ++i)
+            if (st.invMass[i] == 0.f)
+                outer = std::max(outer, std::sqrt(st.px[i] * st.px[i] + st.py[i] * st.py[i]));
+        CHECK(std::fabs(outer - 1.5f * radius) < 1e-5f);
+    }
+}
+
+int main()
+{
+    sps::initSimdDispatch();
+    tiersGetCheaper();
+    tiersKeepThePitch();
+    selectKeepsStorageAndSpan();
+    return sapphire_plugins::tests::failures;
+}
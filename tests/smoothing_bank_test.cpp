@@ -0,0 +1,95 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#include <initializer_list>
+
+#include "test_check.h"
+
+#include "shared/smoothing_bank.h"
+
+using sapphire_plugins::shared::SmoothingBank;
+
+// Run the bank until it settles, or give up after a number of blocks no lag should need
+static int blocksToSettle(SmoothingBank &bank, int limit = 1000000)
+{
+    for (int i = 0; i < limit; ++i)
+    {
+        if (bank.isSettled())
+            return i;
+        bank.process();
+    }
+    return -1;
+}
+
+static void settlesOnLargeTargets()
+{
+    SmoothingBank bank;
+    auto idx = bank.add(0.f);
+    bank.setRateInMilliseconds(5, 48000, 8);
+
+    for (auto t : {20000.f, -20000.f, 440.f, 0.f, 1.f})
+    {
+        bank.setTarget(idx, t);
+        CHECK(!bank.isSettled());
+        CHECK(blocksToSettle(bank) > 0);
+        CHECK(bank.current[idx] == t);
+    }
+}
+
+static void settlesWithOfflineBlock()
+{
+    // A one sample block at a high rate gives the smallest coefficient we use
+    SmoothingBank bank;
+    auto a = bank.add(0.f);
+    auto b = bank.add(1000.f);
+    bank.setRateInMilliseconds(5, 192000, 1);
+
+    bank.setTarget(a, 18000.f);
+    bank.setTarget(b, 1000.5f);
+    CHECK(blocksToSettle(bank) > 0);
+    CHECK(bank.current[a] == 18000.f);
+    CHECK(bank.current[b] == 1000.5f);
+}
+
+static void tracksChangedAndSnap()
+{
+    SmoothingBank bank;
+    auto a = bank.add(0.f);
+    auto b = bank.add(0.5f);
+    bank.setRateInMilliseconds(5, 48000, 8);
+
+    bank.setTarget(a, 1.f);
+    bank.process();
+    CHECK(bank.changed == 1);
+    CHECK(bank.current[a] > 0.f && bank.current[a] < 1.f);
+    CHECK(bank.current[b] == 0.5f);
+
+    bank.changed = 0;
+    bank.snapTo(a, 0.25f);
+    CHECK(bank.isSettled());
+    CHECK(bank.current[a] == 0.25f);
+    CHECK(bank.changed == 1);
+
+    // Setting a target equal to the current value does not wake the bank
+    bank.setTarget(b, 0.5f);
+    CHECK(bank.isSettled());
+}
+
+int main()
+{
+    settlesOnLargeTargets();
+    settlesWithOfflineBlock();
+    tracksChangedAndSnap();
+    return sapphire_plugins::tests::failures;
+}
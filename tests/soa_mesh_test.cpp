@@ -0,0 +1,253 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "test_check.h"
+
+#include "elastika/soa_mesh.h"
+
+namespace sps = sapphire_plugins::shared;
+using namespace sapphire_plugins::elastika;
+
+/*
+ * A square sheet with the border anchored and every cell braced on both diagonals, which
+ * gives inner balls eight springs. Rest lengths are short of the spacing so the sheet is
+ * under tension, and the middle ball starts pulled out of the plane.
+ */
+struct Sheet
+{
+    std::vector<MeshBall> balls;
+    std::vector<MeshSpring> springs;
+};
+
+static Sheet makeSheet(uint32_t side)
+{
+    Sheet res;
+    auto at = [side](uint32_t r, uint32_t c) { return r * side + c; };
+    for (auto r = 0U; r < side; ++r)
+        for (auto c = 0U; c < side; ++c)
+        {
+            bool edge = r == 0 || c == 0 || r == side - 1 || c == side - 1;
+            res.balls.push_back({(float)c, (float)r, 0.f, edge ? 0.f : 1.e-3f});
+        }
+    res.balls[at(side / 2, side / 2)].z = 0.3f;
+
+    auto link = [&](uint32_t a, uint32_t b, float len) { res.springs.push_back({a, b, len}); };
+    for (auto r = 0U; r < side; ++r)
+        for (auto c = 0U; c < side; ++c)
+        {
+            if (c + 1 < side)
+                link(at(r, c), at(r, c + 1), 0.8f);
+            if (r + 1 < side)
+                link(at(r, c), at(r + 1, c), 0.8f);
+            if (r + 1 < side && c + 1 < side)
+            {
+                link(at(r, c), at(r + 1, c + 1), 0.8f * std::sqrt(2.f));
+                link(at(r, c + 1), at(r + 1, c), 0.8f * std::sqrt(2.f));
+            }
+        }
+    return res;
+}
+
+/*
+ * The array of structs mesh the SoA layout replaces, one spring at a time. Given the
+ * springs in the SoA colour order it does the same arithmetic in the same order, so the
+ * two agree to the bit.
+ */
+struct ReferenceMesh
+{
+    struct Ball
+    {
+        float pos[3], vel[3], force[3], invMass;
+    };
+    std::vector<Ball> balls;
+    std::vector<MeshSpring> springs;
+
+    ReferenceMesh(const std::vector<MeshBall> &b, std::vector<MeshSpring> s)
+        : springs(std::move(s))
+    {
+        for (const auto &mb : b)
+            balls.push_back({{mb.x, mb.y, mb.z}, {}, {}, mb.mass > 0.f ? 1.f / mb.mass : 0.f});
+    }
+
+    void update(float dt, float halflife, float stiffness)
+    {
+        const auto damp = std::pow(0.5f, dt / halflife);
+        for (auto &b : balls)
+            b.force[0] = b.force[1] = b.force[2] = 0.f;
+        for (const auto &s : springs)
+        {
+            auto &a = balls[s.a], &b = balls[s.b];
+            float d[3];
+            for (int j = 0; j < 3; ++j)
+                d[j] = b.pos[j] - a.pos[j];
+            auto len = std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+            auto f = len > 0.f ? stiffness * (len - s.restLength) / len : 0.f;
+            for (int j = 0; j < 3; ++j)
+            {
+                a.force[j] += f * d[j];
+                b.force[j] -= f * d[j];
+            }
+        }
+        for (auto &b : balls)
+        {
+            auto g = dt * b.invMass;
+            for (int j = 0; j < 3; ++j)
+                b.vel[j] = damp * b.vel[j] + g * b.force[j];
+            for (int j = 0; j < 3; ++j)
+                b.pos[j] += dt * b.vel[j];
+        }
+    }
+};
+
+static std::vector<MeshSpring> colourOrder(const SoaMesh &mesh)
+{
+    std::vector<MeshSpring> res;
+    for (const auto &c : mesh.springBatches())
+        for (auto i = 0U; i < c.count; ++i)
+            res.push_back({c.ballA[i], c.ballB[i], c.restLength[i]});
+    return res;
+}
+
+static constexpr float dt{1.f / 48000}, halflife{0.05f}, stiffness{40.f};
+
+static void coloursShareNoBall()
+{
+    auto sheet = makeSheet(9);
+    SoaMesh mesh;
+    CHECK(mesh.build(sheet.balls, sheet.springs));
+    CHECK(mesh.springCount() == sheet.springs.size());
+    CHECK(colourOrder(mesh).size() == sheet.springs.size());
+    // Eight springs per inner ball, so greedy colouring needs at most fifteen colours
+    CHECK(mesh.colourCount() >= 8 && mesh.colourCount() <= 15);
+
+    for (const auto &c : mesh.springBatches())
+    {
+        std::vector<int> touched(sheet.balls.size(), 0);
+        for (auto i = 0U; i < c.count; ++i)
+        {
+            ++touched[c.ballA[i]];
+            ++touched[c.ballB[i]];
+        }
+        for (auto t : touched)
+            CHECK(t <= 1);
+    }
+}
+
+// Levels the cpu can't run are left at the best it can, and an empty name clears the override
+static void forceSimdLevel(const char *level)
+{
+#if defined(_WIN32)
+    _putenv_s("SAPPHIRE_SIMD_LEVEL", level);
+#else
+    setenv("SAPPHIRE_SIMD_LEVEL", level, 1);
+#endif
+    sps::initSimdDispatch();
+}
+
+// Every cpu level must match the reference exactly when it walks the springs in the same order
+static void matchesReferenceAtEveryLevel()
+{
+    auto sheet = makeSheet(12);
+    for (auto level : {"generic", "avx2", "avx512"})
+    {
+        forceSimdLevel(level);
+        sps::initSimdDispatch();
+        if (std::strcmp(sps::simdLevelName(sps::activeSimdLevel()), level) != 0)
+            continue;
+
+        SoaMesh mesh;
+        CHECK(mesh.build(sheet.balls, sheet.springs));
+        mesh.setStiffness(stiffness);
+        ReferenceMesh ref(sheet.balls, colourOrder(mesh));
+        for (int s = 0; s < 2000; ++s)
+        {
+            mesh.update(dt, halflife);
+            ref.update(dt, halflife, stiffness);
+        }
+
+        const auto &st = mesh.meshState();
+        int mismatches{0};
+        for (auto i = 0U; i < st.balls; ++i)
+        {
+            const auto &b = ref.balls[i];
+            mismatches += st.px[i] != b.pos[0] || st.py[i] != b.pos[1] || st.pz[i] != b.pos[2];
+            mismatches += st.vx[i] != b.vel[0] || st.vy[i] != b.vel[1] || st.vz[i] != b.vel[2];
+        }
+        CHECK(mismatches == 0);
+    }
+    forceSimdLevel("");
+}
+
+// Against the springs in their original order only the summation order differs
+static void staysCloseToSpringOrder()
+{
+    auto sheet = makeSheet(12);
+    SoaMesh mesh;
+    CHECK(mesh.build(sheet.balls, sheet.springs));
+    mesh.setStiffness(stiffness);
+    ReferenceMesh ref(sheet.balls, sheet.springs);
+    for (int s = 0; s < 2000; ++s)
+    {
+        mesh.update(dt, halflife);
+        ref.update(dt, halflife, stiffness);
+    }
+
+    const auto &st = mesh.meshState();
+    float worst{0.f};
+    for (auto i = 0U; i < st.balls; ++i)
+        worst = std::max(worst, std::fabs(st.pz[i] - ref.balls[i].pos[2]));
+    CHECK(worst < 1e-5f);
+}
+
+static void anchorsHoldAndMotionDecays()
+{
+    auto sheet = makeSheet(9);
+    SoaMesh mesh;
+    CHECK(mesh.build(sheet.balls, sheet.springs));
+    mesh.setStiffness(stiffness);
+    const auto &st = mesh.meshState();
+    const auto centre = 4 * 9 + 4;
+
+    float early{0.f}, late{0.f};
+    for (int s = 0; s < 48000; ++s)
+    {
+        mesh.update(dt, halflife);
+        if (s < 4800)
+            early = std::max(early, std::fabs(st.pz[centre]));
+        else if (s >= 43200)
+            late = std::max(late, std::fabs(st.pz[centre]));
+    }
+    CHECK(late < 0.01f * early);
+    for (auto i = 0U; i < st.balls; ++i)
+        if (sheet.balls[i].mass == 0.f)
+            CHECK(st.px[i] == sheet.balls[i].x && st.pz[i] == 0.f);
+
+    mesh.quiet();
+    CHECK(st.pz[centre] == 0.3f && st.vz[centre] == 0.f);
+}
+
+int main()
+{
+    sps::initSimdDispatch();
+    coloursShareNoBall();
+    matchesReferenceAtEveryLevel();
+    staysCloseToSpringOrder();
+    anchorsHoldAndMotionDecays();
+    return sapphire_plugins::tests::failures;
+}
@@ -0,0 +1,40 @@
+/*
+ * Sapphire Plugins
+ *
+ * Bringing the magical world of CosineKitty's sapphire plugins for rack to your DAW
+ *
+ * Copyright 2024-2025, Don Cross, Paul Walker, Morgon Kanter and other authors, as
+ * described in the github transaction log.
+ *
+ * This project is distributed under the Gnu General Public License, version 3.0 or later.
+ * You can find the LICENSE file at the address below.
+ *
+ * The source code and license are at https://github.com/baconpaul/sapphire-plugins
+ */
+
+#ifndef SAPPHIRE_PLUGINS_TESTS_TEST_CHECK_H
+#define SAPPHIRE_PLUGINS_TESTS_TEST_CHECK_H
+
+#include <cstdio>
+
+/*
+ * The unit tests are small standalone executables run by ctest. A failed CHECK
+ * prints where it failed and the test's main returns the failure count, so there
+ * is nothing to vendor for them.
+ */
+namespace sapphire_plugins::tests
+{
+inline int failures{0};
+}
+
+#define CHECK(cond)                                                                                \
+    do                                                                                             \
+    {                                                                                              \
+        if (!(cond))                                                                               \
+        {                                                                                          \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);                   \
+            ++sapphire_plugins::tests::failures;                                                   \
+        }                                                                                          \
+    } while (0)
+
+#endif // TEST_CHECK_H